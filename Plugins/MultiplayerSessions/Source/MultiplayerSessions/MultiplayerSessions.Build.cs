@@ -8,6 +8,12 @@ public class MultiplayerSessions : ModuleRules
     {
         PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
 
+        // The session telemetry (FSessionTelemetry) is compiled out of Shipping. Set to true to keep it there, to diagnose
+        // the join failures of players
+        bool bSessionTelemetryInShipping = false;
+        bool bWithSessionTelemetry = Target.Configuration != UnrealTargetConfiguration.Shipping || bSessionTelemetryInShipping;
+        PublicDefinitions.Add("WITH_SESSION_TELEMETRY=" + (bWithSessionTelemetry ? "1" : "0"));
+
         PublicIncludePaths.AddRange(
             new string[] {
                 // ... add public include paths required here ...
@@ -44,6 +50,7 @@ public class MultiplayerSessions : ModuleRules
                 "Engine",
                 "Slate",
                 "SlateCore",
+                "TraceLog",
                 // ... add private dependencies that you statically link with here ...
             }
             );
@@ -3,6 +3,7 @@
 #include "Menu.h"
 
 #include "Components/Button.h"
+#include "MultiplayerSessions.h"
 #include "MultiplayerSessionsSubsystem.h"
 #include "OnlineSessionSettings.h"
 
@@ -14,10 +15,24 @@ void UMenu::NativeDestruct()
 
 void UMenu::MenuSetup(int32 NumberOfPublicConnections, FString TypeOfMatch, FString LobbyPath)
 {
+    LobbyMapPath = LobbyPath;
     PathToLobby = FString::Printf(TEXT("%s?listen"), *LobbyPath);
     NumPublicConnections = NumberOfPublicConnections;
     MatchType = TypeOfMatch;
-    AddToViewport();
+    // The widget may be shown again, e.g. when coming back from a match, start from a clean state
+    bJoinRequested = false;
+    if (HostButton)
+    {
+        HostButton->SetIsEnabled(true);
+    }
+    if (JoinButton)
+    {
+        JoinButton->SetIsEnabled(true);
+    }
+    if (!IsInViewport())
+    {
+        AddToViewport();
+    }
     SetVisibility(ESlateVisibility::Visible);
 
     if (const UWorld* World = GetWorld())
@@ -42,11 +57,10 @@ void UMenu::MenuSetup(int32 NumberOfPublicConnections, FString TypeOfMatch, FStr
 
     if (MultiplayerSessionsSubsystem)
     {
-        MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionComplete.AddDynamic(this, &ThisClass::OnCreateSession);
-        MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.AddUObject(this, &ThisClass::OnFindSessions);
-        MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.AddUObject(this, &ThisClass::OnJoinSession);
-        MultiplayerSessionsSubsystem->MultiplayerOnDestroySessionComplete.AddDynamic(this, &ThisClass::OnDestroySession);
-        MultiplayerSessionsSubsystem->MultiplayerOnStartSessionComplete.AddDynamic(this, &ThisClass::OnStartSession);
+        BindSubsystemDelegates();
+
+        // Start searching while the player looks at the menu, so Join doesn't have to wait for the backend
+        MultiplayerSessionsSubsystem->StartSessionPrefetch(MaxSearchResults, MatchType);
     }
 }
 
@@ -74,7 +88,9 @@ void UMenu::HostButtonClicked()
     HostButton->SetIsEnabled(false);
     if (MultiplayerSessionsSubsystem)
     {
-        MultiplayerSessionsSubsystem->CreateSession(NumPublicConnections, MatchType);
+        MultiplayerSessionsSubsystem->StopSessionPrefetch();
+        // The subsystem starts loading the lobby right away, so it is loaded by the time the session is created
+        MultiplayerSessionsSubsystem->CreateSession(NumPublicConnections, MatchType, LobbyMapPath);
     }
 }
 
@@ -83,12 +99,51 @@ void UMenu::JoinButtonClicked()
     JoinButton->SetIsEnabled(false);
     if (MultiplayerSessionsSubsystem)
     {
-        MultiplayerSessionsSubsystem->FindSessions(10000);
+        bJoinRequested = true;
+        MultiplayerSessionsSubsystem->StopSessionPrefetch();
+        MultiplayerSessionsSubsystem->FindSessions(MaxSearchResults, MatchType);
+    }
+}
+
+void UMenu::BindSubsystemDelegates()
+{
+    if (bSubsystemDelegatesBound || MultiplayerSessionsSubsystem == nullptr)
+    {
+        return;
     }
+    bSubsystemDelegatesBound = true;
+
+    MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionComplete.AddDynamic(this, &ThisClass::OnCreateSession);
+    MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.AddUObject(this, &ThisClass::OnFindSessions);
+    MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.AddUObject(this, &ThisClass::OnFindSessionsBatch);
+    MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.AddUObject(this, &ThisClass::OnJoinSession);
+    MultiplayerSessionsSubsystem->MultiplayerOnDestroySessionComplete.AddDynamic(this, &ThisClass::OnDestroySession);
+    MultiplayerSessionsSubsystem->MultiplayerOnStartSessionComplete.AddDynamic(this, &ThisClass::OnStartSession);
+}
+
+void UMenu::UnbindSubsystemDelegates()
+{
+    if (!bSubsystemDelegatesBound || MultiplayerSessionsSubsystem == nullptr)
+    {
+        return;
+    }
+    bSubsystemDelegatesBound = false;
+
+    MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionComplete.RemoveDynamic(this, &ThisClass::OnCreateSession);
+    MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.RemoveAll(this);
+    MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.RemoveAll(this);
+    MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.RemoveAll(this);
+    MultiplayerSessionsSubsystem->MultiplayerOnDestroySessionComplete.RemoveDynamic(this, &ThisClass::OnDestroySession);
+    MultiplayerSessionsSubsystem->MultiplayerOnStartSessionComplete.RemoveDynamic(this, &ThisClass::OnStartSession);
 }
 
 void UMenu::MenuTearDown()
 {
+    if (MultiplayerSessionsSubsystem)
+    {
+        MultiplayerSessionsSubsystem->StopSessionPrefetch();
+    }
+    UnbindSubsystemDelegates();
     RemoveFromParent();
     if (const UWorld* World = GetWorld())
     {
@@ -105,8 +160,7 @@ void UMenu::OnCreateSession(bool bWasSuccessful)
 {
     if (bWasSuccessful)
     {
-        if (GEngine)
-            GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("Session created successfully"));
+        UE_LOG(LogMultiplayerSessions, Log, TEXT("Session created, travelling to %s"), *PathToLobby);
         // Travel to the lobby level
         if (UWorld* World = GetWorld())
         {
@@ -115,6 +169,7 @@ void UMenu::OnCreateSession(bool bWasSuccessful)
     }
     else
     {
+        // The player has to know why nothing happens
         if (GEngine)
             GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Failed to create session"));
 
@@ -125,56 +180,73 @@ void UMenu::OnCreateSession(bool bWasSuccessful)
 
 void UMenu::OnFindSessions(const TArray<FOnlineSessionSearchResult>& SearchResults, bool bWasSuccessful)
 {
-    if (MultiplayerSessionsSubsystem == nullptr)
+    // Already joining a session picked while the search was streaming in
+    if (!bJoinRequested || MultiplayerSessionsSubsystem == nullptr ||
+        MultiplayerSessionsSubsystem->IsOperationInFlight(ESessionOperation::Join))
     {
         return;
     }
 
-    for (const FOnlineSessionSearchResult& SearchResult : SearchResults)
+    // The subsystem joins the best ranked session with our match type, and the next ones if that join fails
+    if (MultiplayerSessionsSubsystem->JoinBestSession(MatchType))
     {
-        FString SettingsValue;
-        SearchResult.Session.SessionSettings.Get(FName("MatchType"), SettingsValue);
-        if (SettingsValue == MatchType)
-        {
-            // Session found
-            if (GEngine)
-                GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("Found a session with the same match type"));
-            // Join the session
-            if (MultiplayerSessionsSubsystem)
-            {
-                MultiplayerSessionsSubsystem->JoinSession(SearchResult);
-            }
-            return;
-        }
+        UE_LOG(LogMultiplayerSessions, Log, TEXT("Joining the best %s session"), *MatchType);
+        return;
     }
     // Reenable the join button if no session was found even if the search was successful
     if (bWasSuccessful || SearchResults.Num() == 0)
     {
+        bJoinRequested = false;
         JoinButton->SetIsEnabled(true);
+        MultiplayerSessionsSubsystem->StartSessionPrefetch(MaxSearchResults, MatchType);
+    }
+}
+void UMenu::OnFindSessionsBatch(const TArray<FOnlineSessionSearchResult>& SearchResults, int32 FirstNewResult)
+{
+    if (!bJoinRequested || MultiplayerSessionsSubsystem == nullptr ||
+        MultiplayerSessionsSubsystem->IsOperationInFlight(ESessionOperation::Join))
+    {
+        return;
+    }
+
+    const int32 ResultIndex = MultiplayerSessionsSubsystem->FindGoodEnoughSearchResult(FirstNewResult, MatchType);
+    if (ResultIndex == INDEX_NONE)
+    {
+        return;
     }
+
+    // Good enough, no need to wait for the rest of the search. The other sessions found so far are tried if it fails
+    MultiplayerSessionsSubsystem->CancelFindSessions();
+    UE_LOG(LogMultiplayerSessions, Log, TEXT("Joining a good enough session before the search completed"));
+    MultiplayerSessionsSubsystem->JoinSearchResult(ResultIndex, MatchType);
 }
+
 void UMenu::OnJoinSession(EOnJoinSessionCompleteResult::Type Result)
 {
-    if (IOnlineSubsystem* OnlineSubsystem = IOnlineSubsystem::Get())
+    if (!bJoinRequested)
     {
-        IOnlineSessionPtr SessionInterface = OnlineSubsystem->GetSessionInterface();
-        if (SessionInterface.IsValid())
+        return;
+    }
+
+    // Ask the subsystem, it may not use the session interface of the default online subsystem
+    FString ConnectionString;
+    if (MultiplayerSessionsSubsystem && MultiplayerSessionsSubsystem->GetResolvedConnectString(ConnectionString))
+    {
+        // Travel to the lobby level using the player controller from the game instance
+        if (APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController())
         {
-            FString ConnectionString;
-            if (SessionInterface->GetResolvedConnectString(NAME_GameSession, ConnectionString))
-            {
-                // Travel to the lobby level using the player controller from the game instance
-                if (APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController())
-                {
-                    PlayerController->ClientTravel(ConnectionString, ETravelType::TRAVEL_Absolute);
-                }
-            }
+            PlayerController->ClientTravel(ConnectionString, ETravelType::TRAVEL_Absolute);
         }
     }
     // Reenable the join button if the session join was unsuccessful
     if (Result != EOnJoinSessionCompleteResult::Success)
     {
+        bJoinRequested = false;
         JoinButton->SetIsEnabled(true);
+        if (MultiplayerSessionsSubsystem)
+        {
+            MultiplayerSessionsSubsystem->StartSessionPrefetch(MaxSearchResults, MatchType);
+        }
     }
 }
 
@@ -183,6 +255,8 @@ void UMenu::OnDestroySession(bool bWasSuccessful)
 }
 void UMenu::OnStartSession(bool bWasSuccessful)
 {
-    if (GEngine)
-        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("Session started successfully"));
+    if (bWasSuccessful)
+    {
+        UE_LOG(LogMultiplayerSessions, Log, TEXT("Session started"));
+    }
 }
@@ -0,0 +1,97 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "MenuManagerSubsystem.h"
+
+#include "Blueprint/UserWidget.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
+#include "Menu.h"
+#include "MultiplayerSessionsSubsystem.h"
+
+bool UMenuManagerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Nobody looks at the menu of a dedicated server
+    return Super::ShouldCreateSubsystem(Outer) && !IsRunningDedicatedServer();
+}
+
+void UMenuManagerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+    // The menu unbinds from the sessions subsystem when we go away, it has to outlive us
+    Collection.InitializeDependency<UMultiplayerSessionsSubsystem>();
+
+    // Loaded while the first map loads, so the menu is ready by the time it is shown
+    if (!MenuClass.IsNull())
+    {
+        MenuClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+            MenuClass.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ThisClass::OnMenuClassLoaded));
+    }
+}
+
+void UMenuManagerSubsystem::Deinitialize()
+{
+    if (Menu)
+    {
+        Menu->MenuTearDown();
+        Menu = nullptr;
+    }
+    if (MenuClassHandle.IsValid())
+    {
+        MenuClassHandle->CancelHandle();
+        MenuClassHandle.Reset();
+    }
+
+    Super::Deinitialize();
+}
+
+void UMenuManagerSubsystem::ShowMenu(int32 NumberOfPublicConnections, FString TypeOfMatch, FString LobbyPath)
+{
+    if (UMenu* MenuWidget = GetOrCreateMenu())
+    {
+        bShowPending = false;
+        MenuWidget->MenuSetup(NumberOfPublicConnections, TypeOfMatch, LobbyPath);
+        return;
+    }
+
+    bShowPending = true;
+    PendingNumPublicConnections = NumberOfPublicConnections;
+    PendingMatchType = MoveTemp(TypeOfMatch);
+    PendingLobbyPath = MoveTemp(LobbyPath);
+}
+
+void UMenuManagerSubsystem::HideMenu()
+{
+    bShowPending = false;
+    if (Menu)
+    {
+        Menu->MenuTearDown();
+    }
+}
+
+bool UMenuManagerSubsystem::IsMenuVisible() const
+{
+    return Menu && Menu->IsInViewport();
+}
+
+void UMenuManagerSubsystem::OnMenuClassLoaded()
+{
+    // The widget is only built once someone asked for the menu, a map that creates WBP_Menu itself would get two
+    if (bShowPending)
+    {
+        ShowMenu(PendingNumPublicConnections, PendingMatchType, PendingLobbyPath);
+    }
+}
+
+UMenu* UMenuManagerSubsystem::GetOrCreateMenu()
+{
+    if (Menu == nullptr)
+    {
+        // Owned by the game instance, not by a world, so it survives the map changes
+        if (UClass* LoadedMenuClass = MenuClass.Get())
+        {
+            Menu = CreateWidget<UMenu>(GetGameInstance(), LoadedMenuClass);
+        }
+    }
+    return Menu;
+}
@@ -0,0 +1,637 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "MockOnlineSession.h"
+
+#include "MockSessionBackendSettings.h"
+#include "MultiplayerSessions.h"
+#include "OnlineSubsystemTypes.h"
+#include "SessionSearchIndex.h"
+
+const FName FMockOnlineSession::MockIdType(TEXT("Mock"));
+
+namespace
+{
+/**
+ * Session info of the mock backend, it only carries the session id.
+ */
+class FMockOnlineSessionInfo : public FOnlineSessionInfo
+{
+public:
+    explicit FMockOnlineSessionInfo(const FUniqueNetIdRef& InSessionId) : SessionId(InSessionId) {}
+
+    virtual const uint8* GetBytes() const override { return nullptr; }
+    virtual int32 GetSize() const override { return sizeof(FMockOnlineSessionInfo); }
+    virtual bool IsValid() const override { return SessionId->IsValid(); }
+    virtual const FUniqueNetId& GetSessionId() const override { return *SessionId; }
+    virtual FString ToString() const override { return SessionId->ToString(); }
+    virtual FString ToDebugString() const override { return FString::Printf(TEXT("MockSession %s"), *SessionId->ToString()); }
+
+private:
+    FUniqueNetIdRef SessionId;
+};
+}    // namespace
+
+FMockOnlineSession::FMockOnlineSession(const UMockSessionBackendSettings& InSettings)
+    : Settings(InSettings)
+    , RandomStream(InSettings.RandomSeed)
+{
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMockOnlineSession::Tick));
+}
+
+FMockOnlineSession::~FMockOnlineSession()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+// Advertised sessions and simulated latency
+
+void FMockOnlineSession::GenerateAdvertisedSessions()
+{
+    if (AdvertisedSessions.Num() > 0 || Settings.MatchTypes.Num() == 0)
+    {
+        return;
+    }
+
+    AdvertisedSessions.SetNum(Settings.NumAdvertisedSessions);
+    for (int32 Index = 0; Index < AdvertisedSessions.Num(); ++Index)
+    {
+        FOnlineSessionSearchResult& SearchResult = AdvertisedSessions[Index];
+        SearchResult.PingInMs = RandomStream.RandRange(Settings.MinPingMs, Settings.MaxPingMs);
+
+        FOnlineSession& Session = SearchResult.Session;
+        Session.OwningUserName = FString::Printf(TEXT("MockHost%d"), Index);
+        Session.OwningUserId = FUniqueNetIdString::Create(Session.OwningUserName, MockIdType);
+        const FString SessionId = FString::Printf(TEXT("MockSession%d"), Index);
+        Session.SessionInfo = MakeShared<FMockOnlineSessionInfo>(FUniqueNetIdString::Create(SessionId, MockIdType));
+
+        Session.SessionSettings.NumPublicConnections = Settings.MaxPublicConnections;
+        Session.SessionSettings.bShouldAdvertise = true;
+        Session.SessionSettings.bAllowJoinInProgress = true;
+        Session.SessionSettings.bUsesPresence = true;
+        Session.SessionSettings.bUseLobbiesIfAvailable = true;
+        Session.SessionSettings.Set(SETTING_MATCHTYPE, Settings.MatchTypes[RandomStream.RandHelper(Settings.MatchTypes.Num())],
+            EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+
+        const float FillRate = RandomStream.FRandRange(Settings.MinFillRate, Settings.MaxFillRate);
+        const int32 NumPlayers =
+            FMath::Clamp(FMath::RoundToInt(FillRate * Settings.MaxPublicConnections), 0, Settings.MaxPublicConnections);
+        Session.NumOpenPublicConnections = Settings.MaxPublicConnections - NumPlayers;
+    }
+}
+
+void FMockOnlineSession::CompleteAfterLatency(TFunction<void()>&& Completion)
+{
+    CompleteAfter((Settings.LatencyMs + RandomStream.FRandRange(0.f, Settings.JitterMs)) / 1000.0, MoveTemp(Completion));
+}
+
+void FMockOnlineSession::CompleteAfter(double DelaySeconds, TFunction<void()>&& Completion)
+{
+    PendingCompletions.Add({FPlatformTime::Seconds() + DelaySeconds, MoveTemp(Completion)});
+}
+
+bool FMockOnlineSession::ShouldFail(float FailureRate)
+{
+    return FailureRate > 0.f && RandomStream.FRand() < FailureRate;
+}
+
+bool FMockOnlineSession::Tick(float DeltaTime)
+{
+    const double Now = FPlatformTime::Seconds();
+
+    // Take the due completions out first, they may start new operations
+    TArray<TFunction<void()>> DueCompletions;
+    for (int32 Index = 0; Index < PendingCompletions.Num();)
+    {
+        if (PendingCompletions[Index].DueTime <= Now)
+        {
+            DueCompletions.Add(MoveTemp(PendingCompletions[Index].Completion));
+            PendingCompletions.RemoveAt(Index);
+        }
+        else
+        {
+            ++Index;
+        }
+    }
+    for (TFunction<void()>& Completion : DueCompletions)
+    {
+        Completion();
+    }
+    return true;
+}
+
+// Named sessions
+
+FUniqueNetIdPtr FMockOnlineSession::CreateSessionIdFromString(const FString& SessionIdStr)
+{
+    return FUniqueNetIdString::Create(SessionIdStr, MockIdType);
+}
+
+FNamedOnlineSession* FMockOnlineSession::GetNamedSession(FName SessionName)
+{
+    return Sessions.FindByPredicate(
+        [SessionName](const FNamedOnlineSession& Session) { return Session.SessionName == SessionName; });
+}
+
+void FMockOnlineSession::RemoveNamedSession(FName SessionName)
+{
+    Sessions.RemoveAll([SessionName](const FNamedOnlineSession& Session) { return Session.SessionName == SessionName; });
+}
+
+FNamedOnlineSession* FMockOnlineSession::AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings)
+{
+    return &Sessions.Emplace_GetRef(SessionName, SessionSettings);
+}
+
+FNamedOnlineSession* FMockOnlineSession::AddNamedSession(FName SessionName, const FOnlineSession& Session)
+{
+    return &Sessions.Emplace_GetRef(SessionName, Session);
+}
+
+bool FMockOnlineSession::HasPresenceSession()
+{
+    return Sessions.ContainsByPredicate([](const FNamedOnlineSession& Session) { return Session.SessionSettings.bUsesPresence; });
+}
+
+EOnlineSessionState::Type FMockOnlineSession::GetSessionState(FName SessionName) const
+{
+    const FNamedOnlineSession* Session =
+        Sessions.FindByPredicate([SessionName](const FNamedOnlineSession& Session) { return Session.SessionName == SessionName; });
+    return Session ? Session->SessionState : EOnlineSessionState::NoSession;
+}
+
+int32 FMockOnlineSession::GetNumSessions()
+{
+    return Sessions.Num();
+}
+
+void FMockOnlineSession::DumpSessionState()
+{
+    for (const FNamedOnlineSession& Session : Sessions)
+    {
+        UE_LOG(LogMultiplayerSessions, Log, TEXT("Mock session %s: %s, %d/%d open"), *Session.SessionName.ToString(),
+            EOnlineSessionState::ToString(Session.SessionState), Session.NumOpenPublicConnections,
+            Session.SessionSettings.NumPublicConnections);
+    }
+}
+
+// Session lifetime
+
+bool FMockOnlineSession::CreateSession(int32 HostingPlayerNum, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+    if (GetNamedSession(SessionName) != nullptr)
+    {
+        return false;
+    }
+
+    FNamedOnlineSession* Session = AddNamedSession(SessionName, NewSessionSettings);
+    Session->HostingPlayerNum = HostingPlayerNum;
+    Session->bHosting = true;
+    Session->NumOpenPublicConnections = NewSessionSettings.NumPublicConnections;
+    Session->NumOpenPrivateConnections = NewSessionSettings.NumPrivateConnections;
+    Session->SessionState = EOnlineSessionState::Creating;
+    Session->SessionInfo = MakeShared<FMockOnlineSessionInfo>(
+        FUniqueNetIdString::Create(FString::Printf(TEXT("MockHostedSession_%s"), *SessionName.ToString()), MockIdType));
+
+    const bool bWillFail = ShouldFail(Settings.CreateFailureRate);
+    CompleteAfterLatency(
+        [this, SessionName, bWillFail]()
+        {
+            if (bWillFail)
+            {
+                RemoveNamedSession(SessionName);
+            }
+            else if (FNamedOnlineSession* CreatedSession = GetNamedSession(SessionName))
+            {
+                CreatedSession->SessionState = EOnlineSessionState::Pending;
+            }
+            TriggerOnCreateSessionCompleteDelegates(SessionName, !bWillFail);
+        });
+    return true;
+}
+
+bool FMockOnlineSession::CreateSession(
+    const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+    if (!CreateSession(0, SessionName, NewSessionSettings))
+    {
+        return false;
+    }
+    GetNamedSession(SessionName)->OwningUserId = HostingPlayerId.AsShared();
+    GetNamedSession(SessionName)->LocalOwnerId = HostingPlayerId.AsShared();
+    return true;
+}
+
+bool FMockOnlineSession::StartSession(FName SessionName)
+{
+    FNamedOnlineSession* Session = GetNamedSession(SessionName);
+    if (Session == nullptr ||
+        (Session->SessionState != EOnlineSessionState::Pending && Session->SessionState != EOnlineSessionState::Ended))
+    {
+        return false;
+    }
+    Session->SessionState = EOnlineSessionState::Starting;
+
+    CompleteAfterLatency(
+        [this, SessionName]()
+        {
+            FNamedOnlineSession* StartedSession = GetNamedSession(SessionName);
+            if (StartedSession)
+            {
+                StartedSession->SessionState = EOnlineSessionState::InProgress;
+            }
+            TriggerOnStartSessionCompleteDelegates(SessionName, StartedSession != nullptr);
+        });
+    return true;
+}
+
+bool FMockOnlineSession::UpdateSession(
+    FName SessionName, FOnlineSessionSettings& UpdatedSessionSettings, bool bShouldRefreshOnlineData)
+{
+    FNamedOnlineSession* Session = GetNamedSession(SessionName);
+    if (Session == nullptr)
+    {
+        return false;
+    }
+    Session->SessionSettings = UpdatedSessionSettings;
+
+    CompleteAfterLatency(
+        [this, SessionName]() { TriggerOnUpdateSessionCompleteDelegates(SessionName, GetNamedSession(SessionName) != nullptr); });
+    return true;
+}
+
+bool FMockOnlineSession::EndSession(FName SessionName)
+{
+    FNamedOnlineSession* Session = GetNamedSession(SessionName);
+    if (Session == nullptr || Session->SessionState != EOnlineSessionState::InProgress)
+    {
+        return false;
+    }
+    Session->SessionState = EOnlineSessionState::Ending;
+
+    CompleteAfterLatency(
+        [this, SessionName]()
+        {
+            FNamedOnlineSession* EndedSession = GetNamedSession(SessionName);
+            if (EndedSession)
+            {
+                EndedSession->SessionState = EOnlineSessionState::Ended;
+            }
+            TriggerOnEndSessionCompleteDelegates(SessionName, EndedSession != nullptr);
+        });
+    return true;
+}
+
+bool FMockOnlineSession::DestroySession(FName SessionName, const FOnDestroySessionCompleteDelegate& CompletionDelegate)
+{
+    FNamedOnlineSession* Session = GetNamedSession(SessionName);
+    if (Session == nullptr || Session->SessionState == EOnlineSessionState::Destroying)
+    {
+        return false;
+    }
+    Session->SessionState = EOnlineSessionState::Destroying;
+
+    CompleteAfterLatency(
+        [this, SessionName, CompletionDelegate]()
+        {
+            RemoveNamedSession(SessionName);
+            CompletionDelegate.ExecuteIfBound(SessionName, true);
+            TriggerOnDestroySessionCompleteDelegates(SessionName, true);
+        });
+    return true;
+}
+
+// Finding and joining sessions
+
+bool FMockOnlineSession::FindSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+    if (CurrentSessionSearch.IsValid())
+    {
+        return false;
+    }
+    GenerateAdvertisedSessions();
+
+    CurrentSessionSearch = SearchSettings;
+    SearchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
+    SearchSettings->SearchResults.Reset();
+
+    const bool bWillFail = ShouldFail(Settings.FindFailureRate);
+    CompleteAfterLatency(
+        [this, SearchSettings, bWillFail]()
+        {
+            // The search was cancelled in the meantime
+            if (CurrentSessionSearch != SearchSettings)
+            {
+                return;
+            }
+
+            if (bWillFail)
+            {
+                CurrentSessionSearch.Reset();
+                SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
+                TriggerOnFindSessionsCompleteDelegates(false);
+                return;
+            }
+
+            // Filter on the match type like a backend that supports query settings would
+            const TSharedRef<TArray<int32>> Matches = MakeShared<TArray<int32>>();
+            FString MatchType;
+            const bool bFilterMatchType = SearchSettings->QuerySettings.Get(SETTING_MATCHTYPE, MatchType);
+            for (int32 Index = 0; Index < AdvertisedSessions.Num() && Matches->Num() < SearchSettings->MaxSearchResults; ++Index)
+            {
+                if (bFilterMatchType)
+                {
+                    FString SessionMatchType;
+                    AdvertisedSessions[Index].Session.SessionSettings.Get(SETTING_MATCHTYPE, SessionMatchType);
+                    if (SessionMatchType != MatchType)
+                    {
+                        continue;
+                    }
+                }
+                Matches->Add(Index);
+            }
+            DeliverSearchResults(SearchSettings, Matches, 0);
+        });
+    return true;
+}
+
+void FMockOnlineSession::DeliverSearchResults(
+    const TSharedRef<FOnlineSessionSearch>& SearchSettings, const TSharedRef<const TArray<int32>>& Matches, int32 FirstMatch)
+{
+    // The search was cancelled in the meantime
+    if (CurrentSessionSearch != SearchSettings)
+    {
+        return;
+    }
+
+    const int32 BatchSize = FMath::Max(FMath::DivideAndRoundUp(Matches->Num(), FMath::Max(Settings.FindResultBatches, 1)), 1);
+    const int32 EndMatch = FMath::Min(FirstMatch + BatchSize, Matches->Num());
+    for (int32 MatchIndex = FirstMatch; MatchIndex < EndMatch; ++MatchIndex)
+    {
+        SearchSettings->SearchResults.Add(AdvertisedSessions[(*Matches)[MatchIndex]]);
+    }
+
+    if (EndMatch < Matches->Num())
+    {
+        CompleteAfter(Settings.FindResultIntervalMs / 1000.0,
+            [this, SearchSettings, Matches, EndMatch]() { DeliverSearchResults(SearchSettings, Matches, EndMatch); });
+        return;
+    }
+
+    CurrentSessionSearch.Reset();
+    SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
+    TriggerOnFindSessionsCompleteDelegates(true);
+}
+
+bool FMockOnlineSession::FindSessions(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+    return FindSessions(0, SearchSettings);
+}
+
+bool FMockOnlineSession::FindSessionById(const FUniqueNetId& SearchingUserId, const FUniqueNetId& SessionId,
+    const FUniqueNetId& FriendId, const FOnSingleSessionResultCompleteDelegate& CompletionDelegate)
+{
+    return false;
+}
+
+bool FMockOnlineSession::CancelFindSessions()
+{
+    if (!CurrentSessionSearch.IsValid())
+    {
+        return false;
+    }
+    CurrentSessionSearch->SearchState = EOnlineAsyncTaskState::Failed;
+    CurrentSessionSearch.Reset();
+    if (Settings.bCompleteCancelFindImmediately)
+    {
+        TriggerOnCancelFindSessionsCompleteDelegates(true);
+    }
+    else
+    {
+        CompleteAfterLatency([this]() { TriggerOnCancelFindSessionsCompleteDelegates(true); });
+    }
+    return true;
+}
+
+bool FMockOnlineSession::PingSearchResults(const FOnlineSessionSearchResult& SearchResult)
+{
+    return false;
+}
+
+bool FMockOnlineSession::JoinSession(int32 LocalUserNum, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+    if (GetNamedSession(SessionName) != nullptr || !DesiredSession.IsValid())
+    {
+        return false;
+    }
+
+    FNamedOnlineSession* Session = AddNamedSession(SessionName, DesiredSession.Session);
+    Session->HostingPlayerNum = INDEX_NONE;
+    Session->bHosting = false;
+    Session->SessionState = EOnlineSessionState::Creating;
+
+    const FString SessionId = DesiredSession.GetSessionIdStr();
+    const bool bWillFail = ShouldFail(Settings.JoinFailureRate);
+    CompleteAfterLatency(
+        [this, SessionName, SessionId, bWillFail]()
+        {
+            // Take the slot in the advertised session, it may have filled up since it was found
+            FOnlineSessionSearchResult* Advertised = AdvertisedSessions.FindByPredicate(
+                [&SessionId](const FOnlineSessionSearchResult& SearchResult)
+                { return SearchResult.GetSessionIdStr() == SessionId; });
+
+            EOnJoinSessionCompleteResult::Type Result = EOnJoinSessionCompleteResult::Success;
+            if (Advertised == nullptr)
+            {
+                Result = EOnJoinSessionCompleteResult::SessionDoesNotExist;
+            }
+            else if (Advertised->Session.NumOpenPublicConnections <= 0)
+            {
+                Result = EOnJoinSessionCompleteResult::SessionIsFull;
+            }
+            else if (bWillFail)
+            {
+                Result = EOnJoinSessionCompleteResult::UnknownError;
+            }
+
+            if (Result == EOnJoinSessionCompleteResult::Success)
+            {
+                --Advertised->Session.NumOpenPublicConnections;
+                if (FNamedOnlineSession* JoinedSession = GetNamedSession(SessionName))
+                {
+                    JoinedSession->SessionState = EOnlineSessionState::Pending;
+                }
+            }
+            else
+            {
+                RemoveNamedSession(SessionName);
+            }
+            TriggerOnJoinSessionCompleteDelegates(SessionName, Result);
+        });
+    return true;
+}
+
+bool FMockOnlineSession::JoinSession(
+    const FUniqueNetId& LocalUserId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+    if (!JoinSession(0, SessionName, DesiredSession))
+    {
+        return false;
+    }
+    GetNamedSession(SessionName)->LocalOwnerId = LocalUserId.AsShared();
+    return true;
+}
+
+bool FMockOnlineSession::GetResolvedConnectString(FName SessionName, FString& ConnectInfo, FName PortType)
+{
+    if (GetNamedSession(SessionName) == nullptr)
+    {
+        return false;
+    }
+    ConnectInfo = Settings.ConnectAddress;
+    return true;
+}
+
+bool FMockOnlineSession::GetResolvedConnectString(
+    const FOnlineSessionSearchResult& SearchResult, FName PortType, FString& ConnectInfo)
+{
+    if (!SearchResult.IsValid())
+    {
+        return false;
+    }
+    ConnectInfo = Settings.ConnectAddress;
+    return true;
+}
+
+FOnlineSessionSettings* FMockOnlineSession::GetSessionSettings(FName SessionName)
+{
+    FNamedOnlineSession* Session = GetNamedSession(SessionName);
+    return Session ? &Session->SessionSettings : nullptr;
+}
+
+// Players
+
+bool FMockOnlineSession::IsPlayerInSession(FName SessionName, const FUniqueNetId& UniqueId)
+{
+    const FNamedOnlineSession* Session = GetNamedSession(SessionName);
+    return Session && Session->RegisteredPlayers.ContainsByPredicate(
+                          [&UniqueId](const FUniqueNetIdRef& PlayerId) { return *PlayerId == UniqueId; });
+}
+
+bool FMockOnlineSession::RegisterPlayer(FName SessionName, const FUniqueNetId& PlayerId, bool bWasInvited)
+{
+    return RegisterPlayers(SessionName, {PlayerId.AsShared()}, bWasInvited);
+}
+
+bool FMockOnlineSession::RegisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players, bool bWasInvited)
+{
+    FNamedOnlineSession* Session = GetNamedSession(SessionName);
+    if (Session != nullptr)
+    {
+        for (const FUniqueNetIdRef& PlayerId : Players)
+        {
+            if (!IsPlayerInSession(SessionName, *PlayerId))
+            {
+                Session->RegisteredPlayers.Add(PlayerId);
+                Session->NumOpenPublicConnections = FMath::Max(Session->NumOpenPublicConnections - 1, 0);
+            }
+        }
+    }
+    TriggerOnRegisterPlayersCompleteDelegates(SessionName, Players, Session != nullptr);
+    return Session != nullptr;
+}
+
+bool FMockOnlineSession::UnregisterPlayer(FName SessionName, const FUniqueNetId& PlayerId)
+{
+    return UnregisterPlayers(SessionName, {PlayerId.AsShared()});
+}
+
+bool FMockOnlineSession::UnregisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players)
+{
+    FNamedOnlineSession* Session = GetNamedSession(SessionName);
+    if (Session != nullptr)
+    {
+        for (const FUniqueNetIdRef& PlayerId : Players)
+        {
+            const int32 NumRemoved = Session->RegisteredPlayers.RemoveAll(
+                [&PlayerId](const FUniqueNetIdRef& Registered) { return *Registered == *PlayerId; });
+            if (NumRemoved > 0)
+            {
+                Session->NumOpenPublicConnections =
+                    FMath::Min(Session->NumOpenPublicConnections + 1, Session->SessionSettings.NumPublicConnections);
+            }
+        }
+    }
+    TriggerOnUnregisterPlayersCompleteDelegates(SessionName, Players, Session != nullptr);
+    return Session != nullptr;
+}
+
+void FMockOnlineSession::RegisterLocalPlayer(
+    const FUniqueNetId& PlayerId, FName SessionName, const FOnRegisterLocalPlayerCompleteDelegate& Delegate)
+{
+    Delegate.ExecuteIfBound(PlayerId, EOnJoinSessionCompleteResult::Success);
+}
+
+void FMockOnlineSession::UnregisterLocalPlayer(
+    const FUniqueNetId& PlayerId, FName SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& Delegate)
+{
+    Delegate.ExecuteIfBound(PlayerId, true);
+}
+
+void FMockOnlineSession::RemovePlayerFromSession(int32 LocalUserNum, FName SessionName, const FUniqueNetId& TargetPlayerId)
+{
+    UnregisterPlayer(SessionName, TargetPlayerId);
+}
+
+// Features the mock backend doesn't simulate
+
+bool FMockOnlineSession::StartMatchmaking(const TArray<FUniqueNetIdRef>& LocalPlayers, FName SessionName,
+    const FOnlineSessionSettings& NewSessionSettings, TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+    return false;
+}
+
+bool FMockOnlineSession::CancelMatchmaking(int32 SearchingPlayerNum, FName SessionName)
+{
+    return false;
+}
+
+bool FMockOnlineSession::CancelMatchmaking(const FUniqueNetId& SearchingPlayerId, FName SessionName)
+{
+    return false;
+}
+
+bool FMockOnlineSession::FindFriendSession(int32 LocalUserNum, const FUniqueNetId& Friend)
+{
+    return false;
+}
+
+bool FMockOnlineSession::FindFriendSession(const FUniqueNetId& LocalUserId, const FUniqueNetId& Friend)
+{
+    return false;
+}
+
+bool FMockOnlineSession::FindFriendSession(const FUniqueNetId& LocalUserId, const TArray<FUniqueNetIdRef>& FriendList)
+{
+    return false;
+}
+
+bool FMockOnlineSession::SendSessionInviteToFriend(int32 LocalUserNum, FName SessionName, const FUniqueNetId& Friend)
+{
+    return false;
+}
+
+bool FMockOnlineSession::SendSessionInviteToFriend(const FUniqueNetId& LocalUserId, FName SessionName, const FUniqueNetId& Friend)
+{
+    return false;
+}
+
+bool FMockOnlineSession::SendSessionInviteToFriends(int32 LocalUserNum, FName SessionName, const TArray<FUniqueNetIdRef>& Friends)
+{
+    return false;
+}
+
+bool FMockOnlineSession::SendSessionInviteToFriends(
+    const FUniqueNetId& LocalUserId, FName SessionName, const TArray<FUniqueNetIdRef>& Friends)
+{
+    return false;
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "CoreMinimal.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSessionSettings.h"
+
+class UMockSessionBackendSettings;
+
+/**
+ * FMockOnlineSession is an in-process session interface that advertises a configurable number of fake sessions.
+ *
+ * It lets the subsystem run Create, Find, Join, Destroy and Start without Steam or a LAN, with a latency, jitter,
+ * failure rate and session fill levels read from UMockSessionBackendSettings. The random stream is seeded from the
+ * settings, so two runs with the same settings see the same sessions and the same failures.
+ * Operations complete on the game thread, from the core ticker, like a real backend would.
+ *
+ * Enable it with bUseMockSessionBackend on the MultiplayerSessionsSubsystem or with -MockSessions on the command line.
+ */
+class FMockOnlineSession : public IOnlineSession
+{
+public:
+    explicit FMockOnlineSession(const UMockSessionBackendSettings& InSettings);
+    virtual ~FMockOnlineSession() override;
+
+    // IOnlineSession interface
+    virtual FUniqueNetIdPtr CreateSessionIdFromString(const FString& SessionIdStr) override;
+    virtual FNamedOnlineSession* GetNamedSession(FName SessionName) override;
+    virtual void RemoveNamedSession(FName SessionName) override;
+    virtual bool HasPresenceSession() override;
+    virtual EOnlineSessionState::Type GetSessionState(FName SessionName) const override;
+    virtual bool CreateSession(
+        int32 HostingPlayerNum, FName SessionName, const FOnlineSessionSettings& NewSessionSettings) override;
+    virtual bool CreateSession(
+        const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings) override;
+    virtual bool StartSession(FName SessionName) override;
+    virtual bool UpdateSession(
+        FName SessionName, FOnlineSessionSettings& UpdatedSessionSettings, bool bShouldRefreshOnlineData = true) override;
+    virtual bool EndSession(FName SessionName) override;
+    virtual bool DestroySession(FName SessionName,
+        const FOnDestroySessionCompleteDelegate& CompletionDelegate = FOnDestroySessionCompleteDelegate()) override;
+    virtual bool IsPlayerInSession(FName SessionName, const FUniqueNetId& UniqueId) override;
+    virtual bool StartMatchmaking(const TArray<FUniqueNetIdRef>& LocalPlayers, FName SessionName,
+        const FOnlineSessionSettings& NewSessionSettings, TSharedRef<FOnlineSessionSearch>& SearchSettings) override;
+    virtual bool CancelMatchmaking(int32 SearchingPlayerNum, FName SessionName) override;
+    virtual bool CancelMatchmaking(const FUniqueNetId& SearchingPlayerId, FName SessionName) override;
+    virtual bool FindSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings) override;
+    virtual bool FindSessions(
+        const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings) override;
+    virtual bool FindSessionById(const FUniqueNetId& SearchingUserId, const FUniqueNetId& SessionId, const FUniqueNetId& FriendId,
+        const FOnSingleSessionResultCompleteDelegate& CompletionDelegate) override;
+    virtual bool CancelFindSessions() override;
+    virtual bool PingSearchResults(const FOnlineSessionSearchResult& SearchResult) override;
+    virtual bool JoinSession(int32 LocalUserNum, FName SessionName, const FOnlineSessionSearchResult& DesiredSession) override;
+    virtual bool JoinSession(
+        const FUniqueNetId& LocalUserId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession) override;
+    virtual bool FindFriendSession(int32 LocalUserNum, const FUniqueNetId& Friend) override;
+    virtual bool FindFriendSession(const FUniqueNetId& LocalUserId, const FUniqueNetId& Friend) override;
+    virtual bool FindFriendSession(const FUniqueNetId& LocalUserId, const TArray<FUniqueNetIdRef>& FriendList) override;
+    virtual bool SendSessionInviteToFriend(int32 LocalUserNum, FName SessionName, const FUniqueNetId& Friend) override;
+    virtual bool SendSessionInviteToFriend(const FUniqueNetId& LocalUserId, FName SessionName, const FUniqueNetId& Friend) override;
+    virtual bool SendSessionInviteToFriends(
+        int32 LocalUserNum, FName SessionName, const TArray<FUniqueNetIdRef>& Friends) override;
+    virtual bool SendSessionInviteToFriends(
+        const FUniqueNetId& LocalUserId, FName SessionName, const TArray<FUniqueNetIdRef>& Friends) override;
+    virtual bool GetResolvedConnectString(FName SessionName, FString& ConnectInfo, FName PortType = NAME_GamePort) override;
+    virtual bool GetResolvedConnectString(
+        const FOnlineSessionSearchResult& SearchResult, FName PortType, FString& ConnectInfo) override;
+    virtual FOnlineSessionSettings* GetSessionSettings(FName SessionName) override;
+    virtual bool RegisterPlayer(FName SessionName, const FUniqueNetId& PlayerId, bool bWasInvited) override;
+    virtual bool RegisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players, bool bWasInvited = false) override;
+    virtual bool UnregisterPlayer(FName SessionName, const FUniqueNetId& PlayerId) override;
+    virtual bool UnregisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players) override;
+    virtual void RegisterLocalPlayer(
+        const FUniqueNetId& PlayerId, FName SessionName, const FOnRegisterLocalPlayerCompleteDelegate& Delegate) override;
+    virtual void UnregisterLocalPlayer(
+        const FUniqueNetId& PlayerId, FName SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& Delegate) override;
+    virtual void RemovePlayerFromSession(int32 LocalUserNum, FName SessionName, const FUniqueNetId& TargetPlayerId) override;
+    virtual int32 GetNumSessions() override;
+    virtual void DumpSessionState() override;
+
+protected:
+    virtual FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings) override;
+    virtual FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSession& Session) override;
+
+private:
+    /** Type of the unique ids made up by the mock backend */
+    static const FName MockIdType;
+
+    /** Creates the advertised sessions the first time they are needed. */
+    void GenerateAdvertisedSessions();
+
+    /** Runs the completion after the simulated latency. */
+    void CompleteAfterLatency(TFunction<void()>&& Completion);
+    /** Runs the completion after the given delay. */
+    void CompleteAfter(double DelaySeconds, TFunction<void()>&& Completion);
+
+    /** Adds the next batch of matching sessions to the search, and completes it with the last one. */
+    void DeliverSearchResults(
+        const TSharedRef<FOnlineSessionSearch>& SearchSettings, const TSharedRef<const TArray<int32>>& Matches, int32 FirstMatch);
+
+    /** Rolls whether an operation with the given failure rate fails. */
+    bool ShouldFail(float FailureRate);
+
+    bool Tick(float DeltaTime);
+
+    struct FPendingCompletion
+    {
+        double DueTime{0.0};
+        TFunction<void()> Completion;
+    };
+
+    const UMockSessionBackendSettings& Settings;
+    FRandomStream RandomStream;
+
+    TArray<FOnlineSessionSearchResult> AdvertisedSessions;
+    TArray<FNamedOnlineSession> Sessions;
+
+    TArray<FPendingCompletion> PendingCompletions;
+    FTSTicker::FDelegateHandle TickerHandle;
+
+    // The search in flight, so it can be cancelled
+    TSharedPtr<FOnlineSessionSearch> CurrentSessionSearch;
+};
@@ -0,0 +1,81 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+
+#include "MockSessionBackendSettings.generated.h"
+
+/**
+ * Settings of the mock session backend, read from the [/Script/MultiplayerSessions.MockSessionBackendSettings] section
+ * of the Game config. See FMockOnlineSession.
+ */
+UCLASS(Config = Game)
+class UMockSessionBackendSettings : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    /** Number of sessions the backend advertises */
+    UPROPERTY(Config)
+    int32 NumAdvertisedSessions{20000};
+
+    /** Match types given to the advertised sessions, picked uniformly */
+    UPROPERTY(Config)
+    TArray<FString> MatchTypes{TEXT("FreeForAll"), TEXT("TeamDeathmatch"), TEXT("CaptureTheFlag")};
+
+    /** Number of public connections of the advertised sessions */
+    UPROPERTY(Config)
+    int32 MaxPublicConnections{16};
+
+    /** Range of the fill rate of the advertised sessions, 0 is empty and 1 is full */
+    UPROPERTY(Config)
+    float MinFillRate{0.f};
+    UPROPERTY(Config)
+    float MaxFillRate{1.f};
+
+    /** Range of the ping reported for the advertised sessions */
+    UPROPERTY(Config)
+    int32 MinPingMs{10};
+    UPROPERTY(Config)
+    int32 MaxPingMs{300};
+
+    /** Time every operation takes to complete, plus a random jitter between 0 and JitterMs */
+    UPROPERTY(Config)
+    float LatencyMs{150.f};
+    UPROPERTY(Config)
+    float JitterMs{100.f};
+
+    /**
+     * Number of batches the results of a search are delivered in, FindResultIntervalMs apart, like servers answering a
+     * query one after the other. 1 delivers every result at once.
+     */
+    UPROPERTY(Config)
+    int32 FindResultBatches{10};
+    UPROPERTY(Config)
+    float FindResultIntervalMs{100.f};
+
+    /**
+     * Whether the cancellation of a search completes inside CancelFindSessions, like with the NULL and Steam session
+     * interfaces, rather than after the latency.
+     */
+    UPROPERTY(Config)
+    bool bCompleteCancelFindImmediately = true;
+
+    /** Probability for each kind of operation to fail */
+    UPROPERTY(Config)
+    float CreateFailureRate{0.f};
+    UPROPERTY(Config)
+    float FindFailureRate{0.f};
+    UPROPERTY(Config)
+    float JoinFailureRate{0.f};
+
+    /** Address returned as the connect string of joined sessions */
+    UPROPERTY(Config)
+    FString ConnectAddress{TEXT("127.0.0.1:7777")};
+
+    /** Seed of the sessions and of the simulated latencies and failures, so runs are reproducible */
+    UPROPERTY(Config)
+    int32 RandomSeed{1234};
+};
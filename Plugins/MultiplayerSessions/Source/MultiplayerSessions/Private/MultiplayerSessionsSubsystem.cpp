@@ -2,182 +2,1217 @@
 
 #include "MultiplayerSessionsSubsystem.h"
 
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "MockOnlineSession.h"
+#include "MockSessionBackendSettings.h"
+#include "MultiplayerSessions.h"
 #include "Online/OnlineSessionNames.h"
 #include "OnlineSessionSettings.h"
 #include "OnlineSubsystem.h"
+#include "SessionRanker.h"
+#include "SessionTelemetry.h"
+
+namespace
+{
+// Whether another session may succeed where this join failed
+bool ShouldTryNextJoinCandidate(EOnJoinSessionCompleteResult::Type Result)
+{
+    return Result == EOnJoinSessionCompleteResult::SessionIsFull ||
+           Result == EOnJoinSessionCompleteResult::SessionDoesNotExist ||
+           Result == EOnJoinSessionCompleteResult::CouldNotRetrieveAddress ||
+           Result == EOnJoinSessionCompleteResult::UnknownError;
+}
+}    // namespace
 
 UMultiplayerSessionsSubsystem::UMultiplayerSessionsSubsystem()
     : CreateSessionCompleteDelegate(FOnCreateSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnCreateSessionComplete))
+    , UpdateSessionCompleteDelegate(FOnUpdateSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnUpdateSessionComplete))
     , FindSessionsCompleteDelegate(FOnFindSessionsCompleteDelegate::CreateUObject(this, &ThisClass::OnFindSessionsComplete))
+    , CancelFindSessionsCompleteDelegate(
+          FOnCancelFindSessionsCompleteDelegate::CreateUObject(this, &ThisClass::OnCancelFindSessionsComplete))
     , JoinSessionCompleteDelegate(FOnJoinSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnJoinSessionComplete))
     , DestroySessionCompleteDelegate(FOnDestroySessionCompleteDelegate::CreateUObject(this, &ThisClass::OnDestroySessionComplete))
     , StartSessionCompleteDelegate(FOnStartSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnStartSessionComplete))
 {
-    // Get the session interface from the online subsystem
-    if (const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get())
+}
+
+void UMultiplayerSessionsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::OnPostLoadMapWithWorld);
+
+    // Resolved once per game instance, not in the constructor which also runs for the class default object.
+    // The config is only loaded after the constructor, so the mock backend is picked here as well
+    if (bUseMockSessionBackend || FParse::Param(FCommandLine::Get(), TEXT("MockSessions")))
+    {
+        UE_LOG(LogMultiplayerSessions, Log, TEXT("Using the mock session backend"));
+        SessionInterface = MakeShared<FMockOnlineSession, ESPMode::ThreadSafe>(*GetDefault<UMockSessionBackendSettings>());
+    }
+    else if (const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get())
     {
         SessionInterface = Subsystem->GetSessionInterface();
     }
+
+#if WITH_SESSION_TELEMETRY
+    if (TelemetryFlushInterval > 0.f)
+    {
+        TelemetryFlushHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &ThisClass::FlushTelemetry), TelemetryFlushInterval);
+    }
+#endif
+}
+
+void UMultiplayerSessionsSubsystem::Deinitialize()
+{
+    UnbindSessionInterfaceDelegates();
+    FTSTicker::GetCoreTicker().RemoveTicker(SessionSearchPollHandle);
+    SessionSearchPollHandle.Reset();
+    for (const TPair<FName, TUniquePtr<FMultiplayerSessionState>>& Session : Sessions)
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(Session.Value->JoinAttemptTimeoutHandle);
+    }
+    Sessions.Reset();
+    StopSessionPrefetch();
+    FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+    ReleasePreloadedMap();
+    InFlightOperations = 0;
+
+    FTSTicker::GetCoreTicker().RemoveTicker(TelemetryFlushHandle);
+    TelemetryFlushHandle.Reset();
+    FlushTelemetry(0.f);
+
+    Super::Deinitialize();
+}
+
+bool UMultiplayerSessionsSubsystem::FlushTelemetry(float DeltaTime)
+{
+#if WITH_SESSION_TELEMETRY
+    FSessionTelemetry::Get().Flush();
+#endif
+    return true;
+}
+
+void UMultiplayerSessionsSubsystem::BindSessionInterfaceDelegates()
+{
+    if (bSessionInterfaceDelegatesBound || !SessionInterface.IsValid())
+    {
+        return;
+    }
+    bSessionInterfaceDelegatesBound = true;
+
+    // Store the delegate handles, so we can remove them later from the delegate lists
+    CreateSessionCompleteDelegateHandle =
+        SessionInterface->AddOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegate);
+    UpdateSessionCompleteDelegateHandle =
+        SessionInterface->AddOnUpdateSessionCompleteDelegate_Handle(UpdateSessionCompleteDelegate);
+    FindSessionsCompleteDelegateHandle = SessionInterface->AddOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegate);
+    CancelFindSessionsCompleteDelegateHandle =
+        SessionInterface->AddOnCancelFindSessionsCompleteDelegate_Handle(CancelFindSessionsCompleteDelegate);
+    JoinSessionCompleteDelegateHandle = SessionInterface->AddOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegate);
+    DestroySessionCompleteDelegateHandle =
+        SessionInterface->AddOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegate);
+    StartSessionCompleteDelegateHandle = SessionInterface->AddOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegate);
+}
+
+void UMultiplayerSessionsSubsystem::UnbindSessionInterfaceDelegates()
+{
+    if (!bSessionInterfaceDelegatesBound)
+    {
+        return;
+    }
+    bSessionInterfaceDelegatesBound = false;
+
+    if (SessionInterface.IsValid())
+    {
+        SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+        SessionInterface->ClearOnUpdateSessionCompleteDelegate_Handle(UpdateSessionCompleteDelegateHandle);
+        SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
+        SessionInterface->ClearOnCancelFindSessionsCompleteDelegate_Handle(CancelFindSessionsCompleteDelegateHandle);
+        SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
+        SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
+        SessionInterface->ClearOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegateHandle);
+    }
+}
+
+bool UMultiplayerSessionsSubsystem::BeginOperation(ESessionOperation Operation)
+{
+    if (IsOperationInFlight(Operation))
+    {
+        return false;
+    }
+    InFlightOperations |= 1u << static_cast<uint8>(Operation);
+    LatencyTracker.Begin(Operation);
+    return true;
+}
+
+bool UMultiplayerSessionsSubsystem::EndOperation(ESessionOperation Operation, bool bWasSuccessful, int32 NumResults)
+{
+    if (!IsOperationInFlight(Operation))
+    {
+        return false;
+    }
+    InFlightOperations &= ~(1u << static_cast<uint8>(Operation));
+    const float DurationMs = LatencyTracker.End(Operation, bWasSuccessful);
+
+#if WITH_SESSION_TELEMETRY
+    FSessionTelemetryEvent Event;
+    Event.Time = FPlatformTime::Seconds();
+    Event.DurationMs = DurationMs;
+    Event.NumResults = NumResults;
+    Event.Operation = Operation;
+    Event.bWasSuccessful = bWasSuccessful;
+    FSessionTelemetry::Get().Record(Event);
+#endif
+    return true;
+}
+
+bool UMultiplayerSessionsSubsystem::BeginOperation(FMultiplayerSessionState& Session, ESessionOperation Operation)
+{
+    const uint8 OperationBit = 1u << static_cast<uint8>(Operation);
+    if ((Session.InFlightOperations & OperationBit) != 0)
+    {
+        return false;
+    }
+    Session.InFlightOperations |= OperationBit;
+    Session.OperationStartCycles[static_cast<int32>(Operation)] = FPlatformTime::Cycles64();
+    return true;
+}
+
+bool UMultiplayerSessionsSubsystem::EndOperation(
+    FMultiplayerSessionState& Session, ESessionOperation Operation, bool bWasSuccessful, uint8 ResultCode)
+{
+    const uint8 OperationBit = 1u << static_cast<uint8>(Operation);
+    if ((Session.InFlightOperations & OperationBit) == 0)
+    {
+        return false;
+    }
+    Session.InFlightOperations &= ~OperationBit;
+    // The tracker only times one operation of a kind at a time, the sessions time theirs themselves
+    const float DurationMs =
+        LatencyTracker.Record(Operation, Session.OperationStartCycles[static_cast<int32>(Operation)], bWasSuccessful);
+
+#if WITH_SESSION_TELEMETRY
+    FSessionTelemetryEvent Event;
+    Event.Time = FPlatformTime::Seconds();
+    Event.SessionName = Session.SessionName;
+    Event.DurationMs = DurationMs;
+    Event.Operation = Operation;
+    Event.ResultCode = ResultCode;
+    Event.bWasSuccessful = bWasSuccessful;
+    FSessionTelemetry::Get().Record(Event);
+#endif
+    return true;
+}
+
+bool UMultiplayerSessionsSubsystem::IsOperationInFlight(ESessionOperation Operation, FName SessionName) const
+{
+    const uint8 OperationBit = 1u << static_cast<uint8>(Operation);
+    if (Operation == ESessionOperation::Find || Operation == ESessionOperation::CancelFind)
+    {
+        return (InFlightOperations & OperationBit) != 0;
+    }
+    const FMultiplayerSessionState* Session = FindSessionState(SessionName);
+    return Session && (Session->InFlightOperations & OperationBit) != 0;
+}
+
+FMultiplayerSessionState& UMultiplayerSessionsSubsystem::GetSessionState(FName SessionName)
+{
+    TUniquePtr<FMultiplayerSessionState>& Session = Sessions.FindOrAdd(SessionName);
+    if (!Session.IsValid())
+    {
+        Session = MakeUnique<FMultiplayerSessionState>();
+        Session->SessionName = SessionName;
+    }
+    return *Session;
+}
+
+const FMultiplayerSessionState* UMultiplayerSessionsSubsystem::FindSessionState(FName SessionName) const
+{
+    const TUniquePtr<FMultiplayerSessionState>* Session = Sessions.Find(SessionName);
+    return Session ? Session->Get() : nullptr;
+}
+
+FMultiplayerSessionDelegates& UMultiplayerSessionsSubsystem::GetSessionDelegates(FName SessionName)
+{
+    return GetSessionState(SessionName).Delegates;
+}
+
+void UMultiplayerSessionsSubsystem::BroadcastCreateSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+    if (SessionName == NAME_GameSession)
+    {
+        MultiplayerOnCreateSessionComplete.Broadcast(bWasSuccessful);
+    }
+    GetSessionState(SessionName).Delegates.OnCreateSessionComplete.Broadcast(bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::BroadcastJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
+{
+    if (SessionName == NAME_GameSession)
+    {
+        MultiplayerOnJoinSessionComplete.Broadcast(Result);
+    }
+    GetSessionState(SessionName).Delegates.OnJoinSessionComplete.Broadcast(Result);
+}
+
+void UMultiplayerSessionsSubsystem::BroadcastDestroySessionComplete(FName SessionName, bool bWasSuccessful)
+{
+    if (SessionName == NAME_GameSession)
+    {
+        MultiplayerOnDestroySessionComplete.Broadcast(bWasSuccessful);
+    }
+    GetSessionState(SessionName).Delegates.OnDestroySessionComplete.Broadcast(bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::BroadcastStartSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+    if (SessionName == NAME_GameSession)
+    {
+        MultiplayerOnStartSessionComplete.Broadcast(bWasSuccessful);
+    }
+    GetSessionState(SessionName).Delegates.OnStartSessionComplete.Broadcast(bWasSuccessful);
 }
 
 // Functions to handle session functionalities
 
-void UMultiplayerSessionsSubsystem::CreateSession(int32 NumPublicConnections, FString MatchType)
+void UMultiplayerSessionsSubsystem::CreateSession(
+    int32 NumPublicConnections, FString MatchType, const FString& MapPath, FName SessionName)
 {
     if (!SessionInterface.IsValid())
     {
         return;
     }
-    // Destroy the existing session if it exists
-    if (const auto ExistingSession = SessionInterface->GetNamedSession(NAME_GameSession); ExistingSession != nullptr)
+    BindSessionInterfaceDelegates();
+
+    // Load the map while the backend creates the session, the travel then finds it in memory
+    PreloadMap(MapPath);
+
+    // The session is already being created, the caller gets the result of that one
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (!BeginOperation(Session, ESessionOperation::Create))
+    {
+        // Still waiting for the old session to be destroyed, the new one will be created with the latest settings
+        if (Session.bCreateSessionOnDestroy)
+        {
+            Session.LastNumPublicConnections = NumPublicConnections;
+            Session.LastMatchType = MatchType;
+            Session.LastMapPath = MapPath;
+        }
+        UE_LOG(LogMultiplayerSessions, Warning, TEXT("Session %s is already being created"), *SessionName.ToString());
+        return;
+    }
+    Session.LastNumPublicConnections = NumPublicConnections;
+    Session.LastMatchType = MatchType;
+    Session.LastMapPath = MapPath;
+
+    FNamedOnlineSession* ExistingSession = SessionInterface->GetNamedSession(SessionName);
+    if (ExistingSession == nullptr)
     {
-        // We need to destroy the session on destroy, so we can create a new one
-        bCreateSessionOnDestroy = true;
-        LastNumPublicConnections = NumPublicConnections;
-        LastMatchType = MatchType;
-        DestroySession();
+        CreateSessionWithLastSettings(SessionName);
+        return;
     }
 
-    // Store the delegate handle, so we can remove it later from the delegate list
-    SessionInterface->AddOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegate);
+    // We are hosting a session that only differs by settings that can change, update it instead of creating a new one
+    const TSharedRef<FOnlineSessionSettings> NewSessionSettings = MakeSessionSettings(NumPublicConnections, MatchType, MapPath);
+    if (CanUpdateSessionInPlace(*ExistingSession, *NewSessionSettings))
+    {
+        if (BeginOperation(Session, ESessionOperation::Update))
+        {
+            Session.PendingUpdateSlotDelta = NumPublicConnections - ExistingSession->SessionSettings.NumPublicConnections;
+            Session.LastSessionSettings = NewSessionSettings;
+            if (SessionInterface->UpdateSession(SessionName, *Session.LastSessionSettings, true))
+            {
+                return;
+            }
+            EndOperation(Session, ESessionOperation::Update);
+            Session.PendingUpdateSlotDelta = 0;
+        }
+    }
+
+    // Destroy the existing session and create the new one once the destroy completed
+    RecreateSessionAfterDestroy(SessionName);
+}
 
+TSharedRef<FOnlineSessionSettings> UMultiplayerSessionsSubsystem::MakeSessionSettings(
+    int32 NumPublicConnections, const FString& MatchType, const FString& MapPath) const
+{
     // We create the session settings
-    LastSessionSettings = MakeShared<FOnlineSessionSettings>();
+    TSharedRef<FOnlineSessionSettings> SessionSettings = MakeShared<FOnlineSessionSettings>();
 
     // If there's a subsystem then the match is LAN, otherwise it's online
-    LastSessionSettings->bIsLANMatch = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL";
-    LastSessionSettings->NumPublicConnections =
+    SessionSettings->bIsLANMatch = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL";
+    SessionSettings->NumPublicConnections =
         NumPublicConnections;    // Number of players that can join the session (not the number of players in the game)
-    LastSessionSettings->bAllowJoinInProgress = true;     // Allow players to join the session even if it's already started
-    LastSessionSettings->bAllowJoinViaPresence = true;    // Allow players to join the session via presence (friends list)
-    LastSessionSettings->bShouldAdvertise = true;    // Advertise the session to the online subsystem so other players can find it
-    LastSessionSettings->bUsesPresence = true;       // Use presence (friends list) to find the session
-    LastSessionSettings->bUseLobbiesIfAvailable = true;    // Use lobbies if available
-    LastSessionSettings->Set(
-        FName("MatchType"), MatchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);    // Set the match type
-    LastSessionSettings->BuildUniqueId = 1;    // Generate a new unique ID for the session
+    SessionSettings->bAllowJoinInProgress = true;    // Allow players to join the session even if it's already started
+    SessionSettings->bShouldAdvertise = true;    // Advertise the session to the online subsystem so other players can find it
 
-    if (const ULocalPlayer* LocalPlayer = GetGameInstance()->GetFirstGamePlayer(); LocalPlayer != nullptr)
+    // A dedicated server has no user: no presence and no lobby, the session is advertised as a game server
+    const bool bDedicated = IsRunningDedicatedServer();
+    SessionSettings->bIsDedicated = bDedicated;
+    SessionSettings->bAllowJoinViaPresence = !bDedicated;     // Allow players to join the session via presence (friends list)
+    SessionSettings->bUsesPresence = !bDedicated;             // Use presence (friends list) to find the session
+    SessionSettings->bUseLobbiesIfAvailable = !bDedicated;    // Use lobbies if available
+    SessionSettings->Set(
+        SETTING_MATCHTYPE, MatchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);    // Set the match type
+    if (!MapPath.IsEmpty())
     {
-        // Create the session and if it fails, remove the delegate handle and broadcast the custom delegate
-        if (!SessionInterface->CreateSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, *LastSessionSettings))
-        {
-            // Remove the delegate handle
-            SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+        // The players joining preload the map while they join
+        SessionSettings->Set(SETTING_MAPNAME, MapPath, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+    }
+    SessionSettings->BuildUniqueId = 1;    // Generate a new unique ID for the session
+    return SessionSettings;
+}
 
-            // Broadcast our own custom delegate
-            MultiplayerOnCreateSessionComplete.Broadcast(false);
-        }
+bool UMultiplayerSessionsSubsystem::CanUpdateSessionInPlace(
+    const FNamedOnlineSession& ExistingSession, const FOnlineSessionSettings& NewSessionSettings) const
+{
+    // Only the host can change the session, and not while it's being torn down
+    const EOnlineSessionState::Type State = ExistingSession.SessionState;
+    if (!ExistingSession.bHosting || State == EOnlineSessionState::Ending || State == EOnlineSessionState::Ended ||
+        State == EOnlineSessionState::Destroying)
+    {
+        return false;
     }
+
+    // Settings that decide how the session is registered with the backend need a new session
+    const FOnlineSessionSettings& ExistingSettings = ExistingSession.SessionSettings;
+    if (ExistingSettings.bIsLANMatch != NewSessionSettings.bIsLANMatch ||
+        ExistingSettings.bUsesPresence != NewSessionSettings.bUsesPresence ||
+        ExistingSettings.bUseLobbiesIfAvailable != NewSessionSettings.bUseLobbiesIfAvailable ||
+        ExistingSettings.bIsDedicated != NewSessionSettings.bIsDedicated)
+    {
+        return false;
+    }
+
+    // The players already in the session must still fit in it
+    const int32 NumPlayersInSession = ExistingSettings.NumPublicConnections - ExistingSession.NumOpenPublicConnections;
+    return NewSessionSettings.NumPublicConnections >= NumPlayersInSession;
 }
 
-void UMultiplayerSessionsSubsystem::FindSessions(int32 MaxSearchResults)
+void UMultiplayerSessionsSubsystem::CreateSessionWithLastSettings(FName SessionName)
+{
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    Session.LastSessionSettings =
+        MakeSessionSettings(Session.LastNumPublicConnections, Session.LastMatchType, Session.LastMapPath);
+
+    // Create the session and if it fails, end the operation and broadcast the custom delegate
+    bool bCreating = false;
+    if (Session.LastSessionSettings->bIsDedicated)
+    {
+        // There is no local player on a dedicated server, the server hosts the session
+        bCreating = SessionInterface->CreateSession(0, SessionName, *Session.LastSessionSettings);
+    }
+    else if (const ULocalPlayer* LocalPlayer = GetGameInstance()->GetFirstGamePlayer())
+    {
+        bCreating =
+            SessionInterface->CreateSession(*LocalPlayer->GetPreferredUniqueNetId(), SessionName, *Session.LastSessionSettings);
+    }
+    if (!bCreating)
+    {
+        EndOperation(Session, ESessionOperation::Create);
+
+        // Broadcast our own custom delegate
+        BroadcastCreateSessionComplete(SessionName, false);
+    }
+}
+
+void UMultiplayerSessionsSubsystem::RecreateSessionAfterDestroy(FName SessionName)
+{
+    // The create waits for the destroy to complete, see OnDestroySessionComplete
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    Session.bCreateSessionOnDestroy = true;
+    DestroySession(SessionName);
+
+    // The destroy failed right away, so the session won't be created either
+    if (Session.bCreateSessionOnDestroy && !IsOperationInFlight(ESessionOperation::Destroy, SessionName))
+    {
+        Session.bCreateSessionOnDestroy = false;
+        EndOperation(Session, ESessionOperation::Create);
+        BroadcastCreateSessionComplete(SessionName, false);
+    }
+}
+
+void UMultiplayerSessionsSubsystem::FindSessions(
+    int32 MaxSearchResults, const FString& MatchType, const TMap<FName, FString>& ExtraQuerySettings)
 {
     if (!SessionInterface.IsValid())
     {
         return;
     }
-    // Store the delegate handle, so we can remove it later from the delegate list
-    SessionInterface->AddOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegate);
+    BindSessionInterfaceDelegates();
 
-    // We create the session search settings
-    LastSessionSearch = MakeShared<FOnlineSessionSearch>();
-    LastSessionSearch->MaxSearchResults = MaxSearchResults;    // Maximum number of search results
-    LastSessionSearch->bIsLanQuery = IOnlineSubsystem::Get()->GetSubsystemName() ==
-                                     "NULL";    // If there's a subsystem then the match is LAN, otherwise it's online
-    LastSessionSearch->QuerySettings.Set(
-        SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);    // Search for sessions with presence (friends list)
+    const FSessionSearchCacheKey Key = MakeSearchCacheKey(MaxSearchResults, MatchType, ExtraQuerySettings);
 
-    const ULocalPlayer* LocalPlayer = GetGameInstance()->GetFirstGamePlayer();
-    if (SessionInterface->FindSessions(*LocalPlayer->GetPreferredUniqueNetId(), LastSessionSearch.ToSharedRef()))
+    // Serve the results from the cache if we searched the same query recently. Not while a search someone waits for is
+    // running, its listeners would hear twice
+    const bool bForegroundSearchPending =
+        IsOperationInFlight(ESessionOperation::Find) && !bPendingSearchIsBackground && !bPendingSearchCancelled;
+    const FCachedSessionSearch* Cached = bForegroundSearchPending ? nullptr : SessionSearchCache.Find(Key);
+    if (Cached)
+    {
+        const double Age = FPlatformTime::Seconds() - Cached->CompletionTime;
+        if (Age <= SessionSearchCacheMaxStaleAge)
+        {
+            // Keep our own reference, the cache entry may be replaced while the delegate is broadcast
+            LastSessionSearch = Cached->Search;
+            LastSessionSearchSummary = Cached->Summary;
+            LastSessionSearchIndex = Cached->Index;
+            BroadcastSessionSearch = LastSessionSearch;
+            BroadcastSearchSummary = LastSessionSearchSummary;
+
+            // The results are getting old, serve them anyway and refresh them for the next call
+            if (Age > SessionSearchCacheTTL)
+            {
+                StartSessionSearch(Key, true);
+            }
+
+            // Same contract as a search that just completed, no sessions is reported as a failure
+            MultiplayerOnFindSessionsComplete.Broadcast(
+                LastSessionSearch->SearchResults, LastSessionSearch->SearchResults.Num() > 0);
+            return;
+        }
+        SessionSearchCache.Remove(Key);
+    }
+
+    if (IsOperationInFlight(ESessionOperation::Find))
+    {
+        if (bPendingSearchCancelled)
+        {
+            // The cancelled search is winding down, this one runs once it did
+            QueuedSearchKey = Key;
+        }
+        else if (PendingSearchKey == Key)
+        {
+            // The same query is already running, maybe as a background refresh. The caller will get its results
+            bPendingSearchIsBackground = false;
+            QueuedSearchKey.Reset();
+        }
+        else
+        {
+            // The running query is not what the caller wants anymore. Its results only go to the cache and this one
+            // runs next, replacing any query queued before it
+            bPendingSearchIsBackground = true;
+            QueuedSearchKey = Key;
+        }
+        return;
+    }
+
+    if (!StartSessionSearch(Key, false))
     {
-        // If the search fails, remove the delegate handle and broadcast the custom delegate
-        SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
         // Broadcast the custom delegate with an empty array because we didn't find any sessions
         MultiplayerOnFindSessionsComplete.Broadcast(TArray<FOnlineSessionSearchResult>(), false);
     }
 }
 
-void UMultiplayerSessionsSubsystem::JoinSession(const FOnlineSessionSearchResult& SearchResult)
+bool UMultiplayerSessionsSubsystem::CancelFindSessions()
+{
+    if (!SessionInterface.IsValid() || !PendingSessionSearch.IsValid() || bPendingSearchCancelled ||
+        IsOperationInFlight(ESessionOperation::CancelFind))
+    {
+        return false;
+    }
+
+    // The search is over for us: its results are not broadcast nor cached and the search queued behind it was asked
+    // for by the same caller, who doesn't want to wait anymore. It is dropped once the backend confirmed, which the
+    // NULL and Steam interfaces do before CancelFindSessions returns, so this is set first
+    const bool bWasBackground = bPendingSearchIsBackground;
+    TOptional<FSessionSearchCacheKey> WasQueuedSearchKey = MoveTemp(QueuedSearchKey);
+    bPendingSearchCancelled = true;
+    bPendingSearchIsBackground = true;
+    QueuedSearchKey.Reset();
+
+    BeginOperation(ESessionOperation::CancelFind);
+    if (!SessionInterface->CancelFindSessions())
+    {
+        EndOperation(ESessionOperation::CancelFind);
+        bPendingSearchCancelled = false;
+        bPendingSearchIsBackground = bWasBackground;
+        QueuedSearchKey = MoveTemp(WasQueuedSearchKey);
+        return false;
+    }
+    return true;
+}
+
+void UMultiplayerSessionsSubsystem::EndCancelledSearch()
+{
+    bPendingSearchCancelled = false;
+    EndOperation(ESessionOperation::Find);
+    PendingSessionSearch.Reset();
+    PendingSearchSummary.Reset();
+    StartQueuedSearch();
+}
+
+void UMultiplayerSessionsSubsystem::StartQueuedSearch()
+{
+    if (QueuedSearchKey.IsSet())
+    {
+        const FSessionSearchCacheKey QueuedKey = QueuedSearchKey.GetValue();
+        QueuedSearchKey.Reset();
+        if (!StartSessionSearch(QueuedKey, false))
+        {
+            MultiplayerOnFindSessionsComplete.Broadcast(TArray<FOnlineSessionSearchResult>(), false);
+        }
+    }
+}
+
+void UMultiplayerSessionsSubsystem::InvalidateSessionSearchCache()
+{
+    SessionSearchCache.Reset();
+}
+
+void UMultiplayerSessionsSubsystem::TrimSessionSearchCache()
+{
+    const double OldestServed = FPlatformTime::Seconds() - SessionSearchCacheMaxStaleAge;
+    for (auto It = SessionSearchCache.CreateIterator(); It; ++It)
+    {
+        if (It.Value().CompletionTime < OldestServed)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    // One query per match type and filter, there are only a few unless the filters come from free text
+    while (SessionSearchCache.Num() > FMath::Max(MaxCachedSearches, 1))
+    {
+        auto Oldest = SessionSearchCache.CreateIterator();
+        for (auto It = SessionSearchCache.CreateIterator(); It; ++It)
+        {
+            if (It.Value().CompletionTime < Oldest.Value().CompletionTime)
+            {
+                Oldest = It;
+            }
+        }
+        Oldest.RemoveCurrent();
+    }
+}
+
+void UMultiplayerSessionsSubsystem::StartSessionPrefetch(int32 MaxSearchResults, const FString& MatchType)
+{
+    if (!bEnableSessionPrefetch || !SessionInterface.IsValid())
+    {
+        return;
+    }
+    BindSessionInterfaceDelegates();
+
+    StopSessionPrefetch();
+    PrefetchSearchKey = MakeSearchCacheKey(MaxSearchResults, MatchType, {});
+    CurrentPrefetchInterval = SessionPrefetchInterval;
+    PrefetchSessions(0.f);
+}
+
+void UMultiplayerSessionsSubsystem::StopSessionPrefetch()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(SessionPrefetchHandle);
+    SessionPrefetchHandle.Reset();
+    PrefetchSearchKey.Reset();
+}
+
+bool UMultiplayerSessionsSubsystem::PrefetchSessions(float DeltaTime)
+{
+    if (!PrefetchSearchKey.IsSet())
+    {
+        return false;
+    }
+
+    // The prefetch is low priority, it waits while anything else runs on the session interface
+    float NextPrefetchDelay = SessionPrefetchInterval;
+    if (InFlightOperations == 0 && StartSessionSearch(PrefetchSearchKey.GetValue(), true))
+    {
+        // Back off while the menu stays up, the player is less and less likely to join any second now
+        NextPrefetchDelay = CurrentPrefetchInterval;
+        CurrentPrefetchInterval = FMath::Min(CurrentPrefetchInterval * SessionPrefetchBackoff, SessionPrefetchMaxInterval);
+    }
+
+    // The delay of a ticker is fixed when it is added, so every refresh gets its own
+    SessionPrefetchHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateUObject(this, &ThisClass::PrefetchSessions), NextPrefetchDelay);
+    return false;
+}
+
+const FSessionSearchSummary& UMultiplayerSessionsSubsystem::GetSearchSummary() const
+{
+    static const FSessionSearchSummary NoSummary;
+    return BroadcastSearchSummary.IsValid() ? *BroadcastSearchSummary : NoSummary;
+}
+
+const FOnlineSessionSearchResult* UMultiplayerSessionsSubsystem::GetSearchResult(int32 ResultIndex) const
+{
+    if (!BroadcastSessionSearch.IsValid() || !BroadcastSessionSearch->SearchResults.IsValidIndex(ResultIndex))
+    {
+        return nullptr;
+    }
+    return &BroadcastSessionSearch->SearchResults[ResultIndex];
+}
+
+const TArray<int32>& UMultiplayerSessionsSubsystem::FindSearchResultsByMatchType(const FString& MatchType) const
+{
+    static const TArray<int32> NoResults;
+    return LastSessionSearchIndex.IsValid() ? LastSessionSearchIndex->Find(MatchType) : NoResults;
+}
+
+const TArray<int32>& UMultiplayerSessionsSubsystem::RankSearchResults(const FString& MatchType)
+{
+    RankedSearchResults.Reset();
+    if (LastSessionSearchSummary.IsValid())
+    {
+        GetSessionRanker()->RankSessions(*LastSessionSearchSummary, FindSearchResultsByMatchType(MatchType), RankedSearchResults);
+    }
+    return RankedSearchResults;
+}
+
+int32 UMultiplayerSessionsSubsystem::FindGoodEnoughSearchResult(int32 FirstResult, const FString& MatchType)
+{
+    const FSessionSearchSummary& Summary = GetSearchSummary();
+
+    // A batch is small, checking the match type hash of each new row is cheaper than indexing them
+    const uint32 MatchTypeHash = FSessionSearchSummary::HashMatchType(MatchType);
+    TArray<int32> Candidates;
+    for (int32 Row = FMath::Max(FirstResult, 0); Row < Summary.Num(); ++Row)
+    {
+        if (MatchType.IsEmpty() || Summary.HasMatchType(Row, MatchType, MatchTypeHash))
+        {
+            Candidates.Add(Row);
+        }
+    }
+    return GetSessionRanker()->PickGoodEnoughSession(Summary, Candidates);
+}
+
+USessionRanker* UMultiplayerSessionsSubsystem::GetSessionRanker()
+{
+    if (SessionRanker == nullptr)
+    {
+        UClass* RankerClass = SessionRankerClass ? SessionRankerClass.Get() : USessionRanker::StaticClass();
+        SessionRanker = NewObject<USessionRanker>(this, RankerClass);
+    }
+    return SessionRanker;
+}
+
+FSessionSearchCacheKey UMultiplayerSessionsSubsystem::MakeSearchCacheKey(
+    int32 MaxSearchResults, const FString& MatchType, const TMap<FName, FString>& ExtraQuerySettings) const
+{
+    FSessionSearchCacheKey Key;
+    Key.MaxSearchResults = MaxSearchResults;
+    // If there's a subsystem then the match is LAN, otherwise it's online
+    Key.bIsLanQuery = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL";
+    Key.bSearchPresence = true;
+    Key.MatchType = MatchType;
+    Key.ExtraQuerySettings = ExtraQuerySettings.Array();
+    Key.ExtraQuerySettings.Sort([](const TPair<FName, FString>& A, const TPair<FName, FString>& B)
+        { return A.Key.LexicalLess(B.Key); });
+    return Key;
+}
+
+bool UMultiplayerSessionsSubsystem::StartSessionSearch(const FSessionSearchCacheKey& Key, bool bBackground)
+{
+    const ULocalPlayer* LocalPlayer = GetGameInstance()->GetFirstGamePlayer();
+    if (LocalPlayer == nullptr)
+    {
+        return false;
+    }
+
+    // Only one search can run on the session interface at a time, a background refresh can wait for the next call
+    if (!BeginOperation(ESessionOperation::Find))
+    {
+        return false;
+    }
+
+    // We create the session search settings
+    PendingSessionSearch = MakeShared<FOnlineSessionSearch>();
+    PendingSessionSearch->MaxSearchResults = Key.MaxSearchResults;    // Maximum number of search results
+    PendingSessionSearch->bIsLanQuery = Key.bIsLanQuery;
+    PendingSessionSearch->QuerySettings.Set(
+        SEARCH_PRESENCE, Key.bSearchPresence, EOnlineComparisonOp::Equals);    // Search for sessions with presence (friends list)
+    // Let the backend filter the sessions, so it doesn't send us every match type
+    if (!Key.MatchType.IsEmpty())
+    {
+        PendingSessionSearch->QuerySettings.Set(SETTING_MATCHTYPE, Key.MatchType, EOnlineComparisonOp::Equals);
+    }
+    for (const TPair<FName, FString>& Setting : Key.ExtraQuerySettings)
+    {
+        PendingSessionSearch->QuerySettings.Set(Setting.Key, Setting.Value, EOnlineComparisonOp::Equals);
+    }
+    PendingSearchKey = Key;
+    bPendingSearchIsBackground = bBackground;
+    PendingSearchSummary = MakeShared<FSessionSearchSummary>();
+
+    if (!SessionInterface->FindSessions(*LocalPlayer->GetPreferredUniqueNetId(), PendingSessionSearch.ToSharedRef()))
+    {
+        // If the search fails, end the operation
+        EndOperation(ESessionOperation::Find);
+        PendingSessionSearch.Reset();
+        PendingSearchSummary.Reset();
+        return false;
+    }
+
+    NumBroadcastSearchResults = 0;
+    if (!SessionSearchPollHandle.IsValid())
+    {
+        SessionSearchPollHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &ThisClass::PollSessionSearch), SessionSearchPollInterval);
+    }
+    return true;
+}
+
+bool UMultiplayerSessionsSubsystem::PollSessionSearch(float DeltaTime)
+{
+    // No search left to poll, the next one starts the ticker again
+    if (!PendingSessionSearch.IsValid())
+    {
+        SessionSearchPollHandle.Reset();
+        return false;
+    }
+    // Nobody waits for the results of a background refresh
+    if (!bPendingSearchIsBackground)
+    {
+        BroadcastNewSearchResults(PendingSessionSearch, PendingSearchSummary);
+    }
+    return true;
+}
+
+void UMultiplayerSessionsSubsystem::BroadcastNewSearchResults(
+    const TSharedPtr<FOnlineSessionSearch>& Search, const TSharedPtr<FSessionSearchSummary>& Summary)
+{
+    // Hold on to them, a listener may cancel the search and release the pending ones while we broadcast
+    const TSharedPtr<FOnlineSessionSearch> SearchToBroadcast = Search;
+    const TSharedPtr<FSessionSearchSummary> SummaryToBroadcast = Summary;
+    if (!SearchToBroadcast.IsValid() || !SummaryToBroadcast.IsValid() ||
+        SearchToBroadcast->SearchResults.Num() <= NumBroadcastSearchResults)
+    {
+        return;
+    }
+    const int32 FirstNewResult = NumBroadcastSearchResults;
+    NumBroadcastSearchResults = SearchToBroadcast->SearchResults.Num();
+
+    // Only the new results are summarized
+    SummaryToBroadcast->Append(SearchToBroadcast->SearchResults);
+    BroadcastSessionSearch = SearchToBroadcast;
+    BroadcastSearchSummary = SummaryToBroadcast;
+    MultiplayerOnFindSessionsBatch.Broadcast(SearchToBroadcast->SearchResults, FirstNewResult);
+}
+
+void UMultiplayerSessionsSubsystem::JoinSession(const FOnlineSessionSearchResult& SearchResult, FName SessionName)
 {
     if (!SessionInterface.IsValid())
     {
-        MultiplayerOnJoinSessionComplete.Broadcast(EOnJoinSessionCompleteResult::UnknownError);
-        UE_LOG(LogTemp, Error, TEXT("Session interface is not valid"));
+        BroadcastJoinSessionComplete(SessionName, EOnJoinSessionCompleteResult::UnknownError);
+        UE_LOG(LogMultiplayerSessions, Error, TEXT("Session interface is not valid"));
+        return;
+    }
+    BindSessionInterfaceDelegates();
+
+    // We are already joining the session, the caller gets the result of that join
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (IsOperationInFlight(ESessionOperation::Join, SessionName) || Session.bJoinNextCandidateOnDestroy ||
+        Session.bWaitForAbandonedJoin)
+    {
+        UE_LOG(LogMultiplayerSessions, Warning, TEXT("Session %s is already being joined"), *SessionName.ToString());
         return;
     }
 
-    // Store the delegate handle, so we can remove it later from the delegate list
-    SessionInterface->AddOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegate);
+    Session.JoinCandidates.Reset();
+    Session.JoinCandidates.Add(SearchResult);
+    Session.NextJoinCandidate = 0;
+    JoinNextCandidate(SessionName, EOnJoinSessionCompleteResult::UnknownError);
+}
 
-    // Join the session
+bool UMultiplayerSessionsSubsystem::JoinBestSession(const FString& MatchType, FName SessionName)
+{
+    if (!SessionInterface.IsValid() || !LastSessionSearch.IsValid())
+    {
+        return false;
+    }
+    return JoinRankedSearchResults(*LastSessionSearch, RankSearchResults(MatchType), SessionName);
+}
+
+bool UMultiplayerSessionsSubsystem::JoinSearchResult(int32 ResultIndex, const FString& MatchType, FName SessionName)
+{
+    // Held on to, cancelling the search may release the pending results
+    const TSharedPtr<const FOnlineSessionSearch> Search = BroadcastSessionSearch;
+    const TSharedPtr<const FSessionSearchSummary> Summary = BroadcastSearchSummary;
+    if (!SessionInterface.IsValid() || !Search.IsValid() || !Summary.IsValid() ||
+        !Search->SearchResults.IsValidIndex(ResultIndex) || ResultIndex >= Summary->Num())
+    {
+        return false;
+    }
+
+    // The given session first, then the rest of what came in so far in rank order
+    TArray<int32> Candidates;
+    const uint32 MatchTypeHash = FSessionSearchSummary::HashMatchType(MatchType);
+    for (int32 Row = 0; Row < Summary->Num(); ++Row)
+    {
+        if (Row != ResultIndex && (MatchType.IsEmpty() || Summary->HasMatchType(Row, MatchType, MatchTypeHash)))
+        {
+            Candidates.Add(Row);
+        }
+    }
+    RankedSearchResults.Reset();
+    GetSessionRanker()->RankSessions(*Summary, Candidates, RankedSearchResults);
+    RankedSearchResults.Insert(ResultIndex, 0);
+    return JoinRankedSearchResults(*Search, RankedSearchResults, SessionName);
+}
+
+bool UMultiplayerSessionsSubsystem::JoinRankedSearchResults(
+    const FOnlineSessionSearch& Search, const TArray<int32>& RankedResults, FName SessionName)
+{
+    BindSessionInterfaceDelegates();
+
+    // We are already joining the session, the caller gets the result of that join
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (IsOperationInFlight(ESessionOperation::Join, SessionName) || Session.bJoinNextCandidateOnDestroy ||
+        Session.bWaitForAbandonedJoin)
+    {
+        UE_LOG(LogMultiplayerSessions, Warning, TEXT("Session %s is already being joined"), *SessionName.ToString());
+        return true;
+    }
+
+    Session.JoinCandidates.Reset();
+    for (int32 Rank = 0; Rank < RankedResults.Num() && Session.JoinCandidates.Num() < MaxJoinAttempts; ++Rank)
+    {
+        Session.JoinCandidates.Add(Search.SearchResults[RankedResults[Rank]]);
+    }
+    if (Session.JoinCandidates.Num() == 0)
+    {
+        return false;
+    }
+
+    Session.NextJoinCandidate = 0;
+    JoinNextCandidate(SessionName, EOnJoinSessionCompleteResult::UnknownError);
+    return true;
+}
+
+void UMultiplayerSessionsSubsystem::JoinNextCandidate(FName SessionName, EOnJoinSessionCompleteResult::Type LastResult)
+{
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
     const ULocalPlayer* LocalPlayer = GetGameInstance()->GetFirstGamePlayer();
-    if (!SessionInterface->JoinSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, SearchResult))
+    while (LocalPlayer && Session.NextJoinCandidate < Session.JoinCandidates.Num())
     {
-        // If the join fails, remove the delegate handle and broadcast the custom delegate with an error
-        SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
-        MultiplayerOnJoinSessionComplete.Broadcast(EOnJoinSessionCompleteResult::UnknownError);
+        if (!BeginOperation(Session, ESessionOperation::Join))
+        {
+            // Two joins in flight on the session couldn't be told apart when they complete
+            UE_LOG(LogMultiplayerSessions, Warning, TEXT("Session %s is already being joined, not trying the next candidate"),
+                *SessionName.ToString());
+            return;
+        }
+        const FOnlineSessionSearchResult& Candidate = Session.JoinCandidates[Session.NextJoinCandidate++];
+
+        // Load the map the host advertises while we join, the travel then finds it in memory
+        FString CandidateMapPath;
+        if (Candidate.Session.SessionSettings.Get(SETTING_MAPNAME, CandidateMapPath))
+        {
+            PreloadMap(CandidateMapPath);
+        }
+
+        // Arm the timeout first, the session interface may complete the join before returning
+        FTSTicker::GetCoreTicker().RemoveTicker(Session.JoinAttemptTimeoutHandle);
+        Session.JoinAttemptTimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &ThisClass::OnJoinAttemptTimeout, SessionName), JoinAttemptTimeout);
+
+        if (SessionInterface->JoinSession(*LocalPlayer->GetPreferredUniqueNetId(), SessionName, Candidate))
+        {
+            return;
+        }
+        // The join couldn't even start, try the next one right away
+        FTSTicker::GetCoreTicker().RemoveTicker(Session.JoinAttemptTimeoutHandle);
+        Session.JoinAttemptTimeoutHandle.Reset();
+        EndOperation(Session, ESessionOperation::Join);
+        LastResult = EOnJoinSessionCompleteResult::UnknownError;
+    }
+
+    // Every candidate failed, now the caller gets to know
+    Session.JoinCandidates.Reset();
+    BroadcastJoinSessionComplete(SessionName, LastResult);
+}
+
+bool UMultiplayerSessionsSubsystem::OnJoinAttemptTimeout(float DeltaTime, FName SessionName)
+{
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    Session.JoinAttemptTimeoutHandle.Reset();
+
+    // The abandoned join didn't complete either, go on without it. It still counts, its completion is dropped
+    if (Session.bWaitForAbandonedJoin)
+    {
+        UE_LOG(LogMultiplayerSessions, Warning, TEXT("The abandoned join of session %s didn't complete yet"),
+            *SessionName.ToString());
+        Session.bWaitForAbandonedJoin = false;
+        JoinNextCandidateAfterAbandonedJoin(SessionName);
+        return false;
+    }
+
+    if (!EndOperation(Session, ESessionOperation::Join))
+    {
+        return false;
+    }
+    UE_LOG(LogMultiplayerSessions, Warning, TEXT("Joining session %s timed out after %.0fs"), *SessionName.ToString(),
+        JoinAttemptTimeout);
+    ++Session.NumAbandonedJoins;
+    Session.bWaitForAbandonedJoin = true;
+    Session.JoinAttemptTimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateUObject(this, &ThisClass::OnJoinAttemptTimeout, SessionName), JoinAttemptTimeout);
+
+    // The session interface may still be joining, leaving the session makes it give up
+    if (SessionInterface->GetNamedSession(SessionName) != nullptr)
+    {
+        Session.bJoinNextCandidateOnDestroy = true;
+        DestroySession(SessionName);
+        if (!IsOperationInFlight(ESessionOperation::Destroy, SessionName))
+        {
+            Session.bJoinNextCandidateOnDestroy = false;
+        }
+    }
+    return false;
+}
+
+void UMultiplayerSessionsSubsystem::JoinNextCandidateAfterAbandonedJoin(FName SessionName)
+{
+    // Already waiting for the destroy, it goes on from there
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (Session.bJoinNextCandidateOnDestroy)
+    {
+        return;
+    }
+
+    // The abandoned join may have created the session after all, it would get in the way of the next join
+    if (SessionInterface->GetNamedSession(SessionName) != nullptr)
+    {
+        Session.bJoinNextCandidateOnDestroy = true;
+        DestroySession(SessionName);
+        if (IsOperationInFlight(ESessionOperation::Destroy, SessionName))
+        {
+            return;
+        }
+        Session.bJoinNextCandidateOnDestroy = false;
     }
+    JoinNextCandidate(SessionName, EOnJoinSessionCompleteResult::UnknownError);
 }
 
-void UMultiplayerSessionsSubsystem::DestroySession()
+void UMultiplayerSessionsSubsystem::DestroySession(FName SessionName)
 {
     if (!SessionInterface.IsValid())
     {
-        MultiplayerOnDestroySessionComplete.Broadcast(false);
-        UE_LOG(LogTemp, Error, TEXT("Session interface is not valid"));
+        BroadcastDestroySessionComplete(SessionName, false);
+        UE_LOG(LogMultiplayerSessions, Error, TEXT("Session interface is not valid"));
+        return;
+    }
+    BindSessionInterfaceDelegates();
+
+    // The session is already being destroyed
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (!BeginOperation(Session, ESessionOperation::Destroy))
+    {
         return;
     }
-    // Store the delegate handle, so we can remove it later from the delegate list
-    SessionInterface->AddOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegate);
 
     // Destroy the session
-    if (!SessionInterface->DestroySession(NAME_GameSession))
+    if (!SessionInterface->DestroySession(SessionName))
     {
-        // If the destroy fails, remove the delegate handle and broadcast the custom delegate with an error
-        SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
-        MultiplayerOnDestroySessionComplete.Broadcast(false);
+        // If the destroy fails, end the operation and broadcast the custom delegate with an error
+        EndOperation(Session, ESessionOperation::Destroy);
+        BroadcastDestroySessionComplete(SessionName, false);
     }
 }
 
-void UMultiplayerSessionsSubsystem::StartSession()
+void UMultiplayerSessionsSubsystem::StartSession(FName SessionName)
 {
     if (!SessionInterface.IsValid())
     {
-        MultiplayerOnStartSessionComplete.Broadcast(false);
-        UE_LOG(LogTemp, Error, TEXT("Session interface is not valid"));
+        BroadcastStartSessionComplete(SessionName, false);
+        UE_LOG(LogMultiplayerSessions, Error, TEXT("Session interface is not valid"));
         return;
     }
+    BindSessionInterfaceDelegates();
 
-    // Store the delegate handle, so we can remove it later from the delegate list
-    SessionInterface->AddOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegate);
+    // The session is already being started
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (!BeginOperation(Session, ESessionOperation::Start))
+    {
+        return;
+    }
 
     // Start the session
-    if (!SessionInterface->StartSession(NAME_GameSession))
+    if (!SessionInterface->StartSession(SessionName))
     {
-        // If the start fails, remove the delegate handle and broadcast the custom delegate with an error
-        SessionInterface->ClearOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegateHandle);
-        MultiplayerOnStartSessionComplete.Broadcast(false);
+        // If the start fails, end the operation and broadcast the custom delegate with an error
+        EndOperation(Session, ESessionOperation::Start);
+        BroadcastStartSessionComplete(SessionName, false);
     }
 }
 
+bool UMultiplayerSessionsSubsystem::GetResolvedConnectString(FString& OutConnectString, FName SessionName) const
+{
+    return SessionInterface.IsValid() && SessionInterface->GetResolvedConnectString(SessionName, OutConnectString);
+}
+
+int32 UMultiplayerSessionsSubsystem::GetNumPublicConnections(FName SessionName) const
+{
+    const FNamedOnlineSession* Session = SessionInterface.IsValid() ? SessionInterface->GetNamedSession(SessionName) : nullptr;
+    return Session ? Session->SessionSettings.NumPublicConnections : 0;
+}
+
+void UMultiplayerSessionsSubsystem::PreloadMap(const FString& MapPath)
+{
+    // PIE travels to duplicates of the maps, a preloaded package would not be used
+    if (!bPreloadSessionMaps || MapPath.IsEmpty() || GIsEditor)
+    {
+        return;
+    }
+
+    // Accept object paths too, e.g. /Game/Maps/Lobby.Lobby
+    const FString PackageName = FPackageName::ObjectPathToPackageName(MapPath);
+    if (PackageName == PreloadingMapPackage)
+    {
+        return;
+    }
+    if (!FPackageName::IsValidLongPackageName(PackageName))
+    {
+        UE_LOG(LogMultiplayerSessions, Warning, TEXT("Not preloading %s, it is not a map package"), *MapPath);
+        return;
+    }
+    ReleasePreloadedMap();
+
+    // Nothing to load if we are already there
+    const UWorld* World = GetWorld();
+    if (World && World->GetOutermost()->GetName() == PackageName)
+    {
+        return;
+    }
+
+    PreloadingMapPackage = PackageName;
+    PreloadStartTime = FPlatformTime::Seconds();
+    LoadPackageAsync(PackageName, FLoadPackageAsyncDelegate::CreateUObject(this, &ThisClass::OnMapPreloaded));
+}
+
+void UMultiplayerSessionsSubsystem::OnMapPreloaded(
+    const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+{
+    // Released or replaced by another map while it loaded
+    if (PackageName.ToString() != PreloadingMapPackage)
+    {
+        return;
+    }
+    if (Result != EAsyncLoadingResult::Succeeded || LoadedPackage == nullptr)
+    {
+        UE_LOG(LogMultiplayerSessions, Warning, TEXT("Failed to preload %s"), *PreloadingMapPackage);
+        PreloadingMapPackage.Reset();
+        return;
+    }
+
+    PreloadedMap = UWorld::FindWorldInPackage(LoadedPackage);
+    UE_LOG(LogMultiplayerSessions, Log, TEXT("Preloaded %s in %.0f ms"), *PreloadingMapPackage,
+        (FPlatformTime::Seconds() - PreloadStartTime) * 1000.0);
+}
+
+void UMultiplayerSessionsSubsystem::ReleasePreloadedMap()
+{
+    PreloadedMap = nullptr;
+    PreloadingMapPackage.Reset();
+}
+
+void UMultiplayerSessionsSubsystem::OnPostLoadMapWithWorld(UWorld* LoadedWorld)
+{
+    // Either we travelled to the preloaded map, it is in use now, or somewhere else and it is not needed anymore.
+    // Keeping it would also keep the world alive once we leave it
+    ReleasePreloadedMap();
+}
+
 // Callbacks for delegates
 
 void UMultiplayerSessionsSubsystem::OnCreateSessionComplete(FName SessionName, bool bWasSuccessful)
 {
-    // Remove the delegate handle
-    if (SessionInterface)
-        SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+    // Ignore the completions of operations we didn't start
+    if (!EndOperation(GetSessionState(SessionName), ESessionOperation::Create, bWasSuccessful))
+    {
+        return;
+    }
 
     // Broadcast our own custom delegate. The menu will receive the value of bWasSuccessful
-    MultiplayerOnCreateSessionComplete.Broadcast(bWasSuccessful);
+    BroadcastCreateSessionComplete(SessionName, bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::OnUpdateSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+    // Ignore the completions of operations we didn't start
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (!EndOperation(Session, ESessionOperation::Update, bWasSuccessful))
+    {
+        return;
+    }
+    const int32 SlotDelta = Session.PendingUpdateSlotDelta;
+    Session.PendingUpdateSlotDelta = 0;
+
+    // The backend refused the new settings, fall back to creating a new session
+    if (!bWasSuccessful)
+    {
+        RecreateSessionAfterDestroy(SessionName);
+        return;
+    }
+
+    // The number of players in the session doesn't change, only the number of slots. Relative to the open connections
+    // now, the players who joined or left while the update was in flight are already counted in them
+    if (FNamedOnlineSession* NamedSession = SessionInterface->GetNamedSession(SessionName))
+    {
+        NamedSession->NumOpenPublicConnections = FMath::Max(NamedSession->NumOpenPublicConnections + SlotDelta, 0);
+    }
+
+    // The update is how the session got created, so this is the completion of the create
+    EndOperation(Session, ESessionOperation::Create, true);
+    BroadcastCreateSessionComplete(SessionName, true);
 }
 
 void UMultiplayerSessionsSubsystem::OnFindSessionsComplete(bool bWasSuccessful)
 {
-    // Remove the delegate handle
-    if (SessionInterface)
-        SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
+    // The cancelled search completed before the backend confirmed the cancellation, or instead of it
+    if (bPendingSearchCancelled)
+    {
+        EndCancelledSearch();
+        return;
+    }
+
+    // Ignore the completions of searches we didn't start
+    const int32 NumResults = PendingSessionSearch.IsValid() ? PendingSessionSearch->SearchResults.Num() : 0;
+    if (!EndOperation(ESessionOperation::Find, bWasSuccessful, NumResults) || !PendingSessionSearch.IsValid())
+    {
+        return;
+    }
+    const TSharedPtr<FOnlineSessionSearch> CompletedSearch = MoveTemp(PendingSessionSearch);
+    const TSharedRef<FSessionSearchSummary> CompletedSearchSummary =
+        PendingSearchSummary.IsValid() ? PendingSearchSummary.ToSharedRef() : MakeShared<FSessionSearchSummary>();
+    PendingSearchSummary.Reset();
+    const FSessionSearchCacheKey CompletedSearchKey = PendingSearchKey;
+    const bool bWasBackground = bPendingSearchIsBackground;
+
+    // The results that came in since the last poll, so the batches add up to the whole search
+    if (!bWasBackground)
+    {
+        BroadcastNewSearchResults(CompletedSearch, CompletedSearchSummary);
+    }
+
+    // Summarize and index the results once, the ranking and every lookup by match type are then served from them
+    CompletedSearchSummary->Append(CompletedSearch->SearchResults);
+    const TSharedRef<FSessionSearchIndex> CompletedSearchIndex = MakeShared<FSessionSearchIndex>();
+    CompletedSearchIndex->Build(*CompletedSearchSummary);
+
+    if (bWasSuccessful)
+    {
+        SessionSearchCache.Add(CompletedSearchKey,
+            {CompletedSearch, CompletedSearchSummary, CompletedSearchIndex, FPlatformTime::Seconds()});
+        TrimSessionSearchCache();
+    }
+
+    // Run the search that was requested while this one was running
+    StartQueuedSearch();
+
+    // Nobody is waiting for a background refresh, the results are picked up from the cache by the next search
+    if (bWasBackground)
+    {
+        return;
+    }
+    LastSessionSearch = CompletedSearch;
+    LastSessionSearchSummary = CompletedSearchSummary;
+    LastSessionSearchIndex = CompletedSearchIndex;
+    BroadcastSessionSearch = CompletedSearch;
+    BroadcastSearchSummary = CompletedSearchSummary;
 
     if (LastSessionSearch->SearchResults.Num() <= 0)
     {
@@ -190,39 +1225,112 @@ void UMultiplayerSessionsSubsystem::OnFindSessionsComplete(bool bWasSuccessful)
     MultiplayerOnFindSessionsComplete.Broadcast(LastSessionSearch->SearchResults, bWasSuccessful);
 }
 
+void UMultiplayerSessionsSubsystem::OnCancelFindSessionsComplete(bool bWasSuccessful)
+{
+    // Ignore the completions of operations we didn't start
+    if (!EndOperation(ESessionOperation::CancelFind, bWasSuccessful))
+    {
+        return;
+    }
+    // The backend stopped the search, it won't complete. When it couldn't, the search ends when it completes
+    if (bWasSuccessful && bPendingSearchCancelled)
+    {
+        EndCancelledSearch();
+    }
+    MultiplayerOnCancelFindSessionsComplete.Broadcast(bWasSuccessful);
+}
+
 void UMultiplayerSessionsSubsystem::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
 {
-    // Remove the delegate handle
-    if (SessionInterface)
-        SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
+    // The late completion of a join that timed out, whatever its result. The next candidate waits for the last one
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (Session.NumAbandonedJoins > 0)
+    {
+        --Session.NumAbandonedJoins;
+        if (Session.bWaitForAbandonedJoin && Session.NumAbandonedJoins == 0)
+        {
+            FTSTicker::GetCoreTicker().RemoveTicker(Session.JoinAttemptTimeoutHandle);
+            Session.JoinAttemptTimeoutHandle.Reset();
+            Session.bWaitForAbandonedJoin = false;
+            JoinNextCandidateAfterAbandonedJoin(SessionName);
+        }
+        return;
+    }
+
+    // Ignore the completions of operations we didn't start
+    if (!EndOperation(Session, ESessionOperation::Join, Result == EOnJoinSessionCompleteResult::Success, Result))
+    {
+        return;
+    }
+
+    FTSTicker::GetCoreTicker().RemoveTicker(Session.JoinAttemptTimeoutHandle);
+    Session.JoinAttemptTimeoutHandle.Reset();
+
+    if (Result != EOnJoinSessionCompleteResult::Success)
+    {
+        // The session we picked from the search results is full or gone, so the cached results can't be trusted anymore
+        InvalidateSessionSearchCache();
+
+        // Another candidate may still work, the menu only hears about the failure once they all failed
+        if (ShouldTryNextJoinCandidate(Result))
+        {
+            UE_LOG(LogMultiplayerSessions, Warning, TEXT("Failed to join session %s (%s), trying the next candidate"),
+                *SessionName.ToString(), LexToString(Result));
+            JoinNextCandidate(SessionName, Result);
+            return;
+        }
+    }
+    Session.JoinCandidates.Reset();
 
     // Broadcast our own custom delegate. The menu will receive the result of the join operation
-    MultiplayerOnJoinSessionComplete.Broadcast(Result);
+    BroadcastJoinSessionComplete(SessionName, Result);
 }
 
 void UMultiplayerSessionsSubsystem::OnDestroySessionComplete(FName SessionName, bool bWasSuccessful)
 {
-    // Remove the delegate handle
-    if (SessionInterface)
-        SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
+    // Ignore the completions of operations we didn't start
+    FMultiplayerSessionState& Session = GetSessionState(SessionName);
+    if (!EndOperation(Session, ESessionOperation::Destroy, bWasSuccessful))
+    {
+        return;
+    }
 
     // Check if we need to create a session after destroying the current one
-    if (bWasSuccessful && bCreateSessionOnDestroy)
+    if (Session.bCreateSessionOnDestroy)
     {
-        bCreateSessionOnDestroy = false;
-        // Create a new session with the last settings
-        CreateSession(LastNumPublicConnections, LastMatchType);
+        Session.bCreateSessionOnDestroy = false;
+        if (bWasSuccessful)
+        {
+            // Create a new session with the last settings, the create operation is still in flight
+            CreateSessionWithLastSettings(SessionName);
+        }
+        else
+        {
+            EndOperation(Session, ESessionOperation::Create);
+            BroadcastCreateSessionComplete(SessionName, false);
+        }
+    }
+    // A join timed out and this was the session it left behind, go on with the next candidate once the join is over
+    if (Session.bJoinNextCandidateOnDestroy)
+    {
+        Session.bJoinNextCandidateOnDestroy = false;
+        if (!Session.bWaitForAbandonedJoin)
+        {
+            JoinNextCandidateAfterAbandonedJoin(SessionName);
+        }
     }
     // Broadcast our own custom delegate. The menu will receive the value of bWasSuccessful
-    MultiplayerOnDestroySessionComplete.Broadcast(bWasSuccessful);
+    BroadcastDestroySessionComplete(SessionName, bWasSuccessful);
 }
 
 void UMultiplayerSessionsSubsystem::OnStartSessionComplete(FName SessionName, bool bWasSuccessful)
 {
-    // Remove the delegate handle
-    if (SessionInterface)
-        SessionInterface->ClearOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegateHandle);
+    // Ignore the completions of operations we didn't start
+    if (!EndOperation(GetSessionState(SessionName), ESessionOperation::Start, bWasSuccessful))
+    {
+        return;
+    }
 
     // Broadcast our own custom delegate. The menu will receive the value of bWasSuccessful
-    MultiplayerOnStartSessionComplete.Broadcast(bWasSuccessful);
+    BroadcastStartSessionComplete(SessionName, bWasSuccessful);
 }
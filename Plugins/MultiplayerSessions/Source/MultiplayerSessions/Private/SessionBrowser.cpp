@@ -0,0 +1,419 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SessionBrowser.h"
+
+#include "Components/Button.h"
+#include "Components/ListView.h"
+#include "MultiplayerSessions.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "OnlineSessionSettings.h"
+#include "SessionBrowserEntry.h"
+#include "SessionSearchSummary.h"
+
+bool USessionBrowser::Initialize()
+{
+    if (!Super::Initialize())
+    {
+        return false;
+    }
+
+    if (RefreshButton)
+    {
+        RefreshButton->OnClicked.AddDynamic(this, &ThisClass::RefreshButtonClicked);
+    }
+    if (JoinButton)
+    {
+        JoinButton->OnClicked.AddDynamic(this, &ThisClass::JoinButtonClicked);
+    }
+    if (SessionList)
+    {
+        SessionList->OnItemDoubleClicked().AddUObject(this, &ThisClass::OnSessionDoubleClicked);
+    }
+
+    return true;
+}
+
+void USessionBrowser::NativeConstruct()
+{
+    Super::NativeConstruct();
+
+    MatchTypeFilterHash = FSessionSearchSummary::HashMatchType(MatchTypeFilter);
+
+    if (UGameInstance* GameInstance = GetGameInstance())
+    {
+        MultiplayerSessionsSubsystem = GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>();
+    }
+    if (MultiplayerSessionsSubsystem == nullptr)
+    {
+        return;
+    }
+
+    MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.AddUObject(this, &ThisClass::OnFindSessionsBatch);
+    MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.AddUObject(this, &ThisClass::OnFindSessions);
+    MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.AddUObject(this, &ThisClass::OnJoinSession);
+
+    // Show what the last search found right away, the refresh then updates it in place
+    ++Generation;
+    MergeSummaryRows(MultiplayerSessionsSubsystem->GetSearchSummary(), 0);
+    SessionList->SetListItems(ListedEntries);
+    RefreshSessions();
+}
+
+void USessionBrowser::NativeDestruct()
+{
+    if (MultiplayerSessionsSubsystem)
+    {
+        MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.RemoveAll(this);
+        MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.RemoveAll(this);
+        MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.RemoveAll(this);
+    }
+    Super::NativeDestruct();
+}
+
+void USessionBrowser::RefreshSessions()
+{
+    if (MultiplayerSessionsSubsystem)
+    {
+        // Every match type is searched, the match type filter is applied here so changing it doesn't search again
+        MultiplayerSessionsSubsystem->FindSessions(MaxSearchResults);
+    }
+}
+
+void USessionBrowser::JoinSelectedSession()
+{
+    const USessionBrowserEntry* Entry = SessionList->GetSelectedItem<USessionBrowserEntry>();
+    if (Entry == nullptr || MultiplayerSessionsSubsystem == nullptr ||
+        MultiplayerSessionsSubsystem->IsOperationInFlight(ESessionOperation::Join))
+    {
+        return;
+    }
+
+    // The entry may still come from the previous search while a new one streams in, only join it if the result it
+    // points to is the same session
+    const FSessionSearchSummary& Summary = MultiplayerSessionsSubsystem->GetSearchSummary();
+    const FOnlineSessionSearchResult* SearchResult = MultiplayerSessionsSubsystem->GetSearchResult(Entry->ResultIndex);
+    if (SearchResult == nullptr || Entry->ResultIndex >= Summary.Num() ||
+        !Summary.GetSessionId(Entry->ResultIndex).Equals(Entry->SessionId, ESearchCase::CaseSensitive))
+    {
+        UE_LOG(LogMultiplayerSessions, Warning,
+            TEXT("The selected session is not in the current search results, refresh the list"));
+        return;
+    }
+
+    // Copy the result first, cancelling the search releases the results
+    const FOnlineSessionSearchResult SessionToJoin = *SearchResult;
+    if (MultiplayerSessionsSubsystem->IsOperationInFlight(ESessionOperation::Find))
+    {
+        MultiplayerSessionsSubsystem->CancelFindSessions();
+    }
+    MultiplayerSessionsSubsystem->StopSessionPrefetch();
+
+    bJoinRequested = true;
+    if (JoinButton)
+    {
+        JoinButton->SetIsEnabled(false);
+    }
+    MultiplayerSessionsSubsystem->JoinSession(SessionToJoin);
+}
+
+void USessionBrowser::SetSortKey(ESessionBrowserSortKey NewSortKey, bool bNewSortDescending)
+{
+    if (SortKey == NewSortKey && bSortDescending == bNewSortDescending)
+    {
+        return;
+    }
+    SortKey = NewSortKey;
+    bSortDescending = bNewSortDescending;
+    RebuildListedEntries();
+}
+
+void USessionBrowser::SetMatchTypeFilter(const FString& NewMatchTypeFilter)
+{
+    if (MatchTypeFilter.Equals(NewMatchTypeFilter, ESearchCase::IgnoreCase))
+    {
+        return;
+    }
+    MatchTypeFilter = NewMatchTypeFilter;
+    MatchTypeFilterHash = FSessionSearchSummary::HashMatchType(MatchTypeFilter);
+    RebuildListedEntries();
+}
+
+void USessionBrowser::SetMaxPingFilter(int32 NewMaxPingMs)
+{
+    if (MaxPingMs == NewMaxPingMs)
+    {
+        return;
+    }
+    MaxPingMs = NewMaxPingMs;
+    RebuildListedEntries();
+}
+
+void USessionBrowser::SetOccupancyFilter(bool bNewHideFullSessions, bool bNewHideEmptySessions)
+{
+    if (bHideFullSessions == bNewHideFullSessions && bHideEmptySessions == bNewHideEmptySessions)
+    {
+        return;
+    }
+    bHideFullSessions = bNewHideFullSessions;
+    bHideEmptySessions = bNewHideEmptySessions;
+    RebuildListedEntries();
+}
+
+void USessionBrowser::OnFindSessionsBatch(const TArray<FOnlineSessionSearchResult>& SearchResults, int32 FirstNewResult)
+{
+    // The first batch of a search starts a new generation. The sessions of the previous search stay listed until this
+    // one completes, so the list doesn't empty and fill up again on every refresh
+    if (FirstNewResult == 0)
+    {
+        ++Generation;
+    }
+    if (MergeSummaryRows(MultiplayerSessionsSubsystem->GetSearchSummary(), FirstNewResult))
+    {
+        SessionList->SetListItems(ListedEntries);
+    }
+}
+
+void USessionBrowser::OnFindSessions(const TArray<FOnlineSessionSearchResult>& SearchResults, bool bWasSuccessful)
+{
+    // The whole search is merged again, results served from the cache don't come in batches. Entries the batches
+    // already updated compare equal and stay where they are
+    ++Generation;
+    bool bListChanged = MergeSummaryRows(MultiplayerSessionsSubsystem->GetSearchSummary(), 0);
+    bListChanged |= RemoveUnseenEntries();
+    if (bListChanged)
+    {
+        SessionList->SetListItems(ListedEntries);
+    }
+}
+
+void USessionBrowser::OnJoinSession(EOnJoinSessionCompleteResult::Type Result)
+{
+    // Someone else joined, e.g. the menu
+    if (!bJoinRequested)
+    {
+        return;
+    }
+    bJoinRequested = false;
+
+    FString ConnectionString;
+    if (Result == EOnJoinSessionCompleteResult::Success &&
+        MultiplayerSessionsSubsystem->GetResolvedConnectString(ConnectionString))
+    {
+        if (APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController())
+        {
+            PlayerController->ClientTravel(ConnectionString, ETravelType::TRAVEL_Absolute);
+            return;
+        }
+    }
+
+    // Let the player pick another session
+    if (JoinButton)
+    {
+        JoinButton->SetIsEnabled(true);
+    }
+}
+
+void USessionBrowser::OnSessionDoubleClicked(UObject* Item)
+{
+    SessionList->SetSelectedItem(Item);
+    JoinSelectedSession();
+}
+
+void USessionBrowser::RefreshButtonClicked()
+{
+    RefreshSessions();
+}
+
+void USessionBrowser::JoinButtonClicked()
+{
+    JoinSelectedSession();
+}
+
+bool USessionBrowser::MergeSummaryRows(const FSessionSearchSummary& Summary, int32 FirstRow)
+{
+    bool bUnlistedAny = false;
+    TArray<TObjectPtr<USessionBrowserEntry>> EntriesToList;
+    // Reused for every row, the map only copies it for the new sessions
+    FString SessionId;
+    for (int32 Row = FMath::Max(FirstRow, 0); Row < Summary.Num(); ++Row)
+    {
+        // Sessions without session info can't be joined
+        if (!Summary.IsValid(Row))
+        {
+            continue;
+        }
+
+        SessionId.Reset();
+        SessionId.Append(Summary.GetSessionId(Row).GetData(), Summary.GetSessionId(Row).Len());
+        TObjectPtr<USessionBrowserEntry>& Entry = EntriesBySessionId.FindOrAdd(SessionId);
+        const bool bIsNewEntry = Entry == nullptr;
+        if (bIsNewEntry)
+        {
+            Entry = FreeEntries.Num() > 0 ? FreeEntries.Pop(EAllowShrinking::No) : NewObject<USessionBrowserEntry>(this);
+        }
+        // Every row is merged once per search, a session that is twice in the results keeps its first row
+        else if (Entry->SeenGeneration == Generation)
+        {
+            continue;
+        }
+
+        const ESessionBrowserEntryChange Changes = Entry->UpdateFrom(Summary, Row);
+        Entry->SeenGeneration = Generation;
+
+        // Unlist the entry if it no longer passes the filter or it may have to move, it is inserted again below
+        const bool bPassesFilter = PassesFilter(*Entry);
+        if (Entry->bIsListed && (!bPassesFilter || AffectsListPosition(Changes)))
+        {
+            Entry->bIsListed = false;
+            bUnlistedAny = true;
+        }
+        if (bPassesFilter && !Entry->bIsListed)
+        {
+            EntriesToList.Add(Entry);
+        }
+
+        // The row widget showing the entry, if it is on screen, refreshes the fields that changed
+        if (!bIsNewEntry && Changes != ESessionBrowserEntryChange::None)
+        {
+            Entry->OnChanged.Broadcast(Changes);
+        }
+    }
+
+    if (bUnlistedAny)
+    {
+        ListedEntries.RemoveAll([](const TObjectPtr<USessionBrowserEntry>& Entry) { return !Entry->bIsListed; });
+    }
+    if (EntriesToList.Num() == 0)
+    {
+        return bUnlistedAny;
+    }
+
+    // Sort the few entries of the batch and merge them into the listed ones, which are already sorted. That is linear
+    // in the number of listed sessions, sorting the whole list again for every batch is not
+    auto ListedBefore = [this](const USessionBrowserEntry& A, const USessionBrowserEntry& B) { return IsListedBefore(A, B); };
+    EntriesToList.Sort(ListedBefore);
+
+    TArray<TObjectPtr<USessionBrowserEntry>> MergedEntries;
+    MergedEntries.Reserve(ListedEntries.Num() + EntriesToList.Num());
+    int32 ListedIndex = 0;
+    for (const TObjectPtr<USessionBrowserEntry>& Entry : EntriesToList)
+    {
+        while (ListedIndex < ListedEntries.Num() && !ListedBefore(*Entry, *ListedEntries[ListedIndex]))
+        {
+            MergedEntries.Add(ListedEntries[ListedIndex++]);
+        }
+        Entry->bIsListed = true;
+        MergedEntries.Add(Entry);
+    }
+    MergedEntries.Append(ListedEntries.GetData() + ListedIndex, ListedEntries.Num() - ListedIndex);
+    ListedEntries = MoveTemp(MergedEntries);
+    return true;
+}
+
+bool USessionBrowser::RemoveUnseenEntries()
+{
+    bool bUnlistedAny = false;
+    for (auto It = EntriesBySessionId.CreateIterator(); It; ++It)
+    {
+        USessionBrowserEntry* Entry = It.Value();
+        if (Entry->SeenGeneration == Generation)
+        {
+            continue;
+        }
+        bUnlistedAny |= Entry->bIsListed;
+        Entry->bIsListed = false;
+        FreeEntries.Add(Entry);
+        It.RemoveCurrent();
+    }
+
+    if (bUnlistedAny)
+    {
+        ListedEntries.RemoveAll([](const TObjectPtr<USessionBrowserEntry>& Entry) { return !Entry->bIsListed; });
+    }
+    return bUnlistedAny;
+}
+
+void USessionBrowser::RebuildListedEntries()
+{
+    ListedEntries.Reset();
+    for (const TPair<FString, TObjectPtr<USessionBrowserEntry>>& Pair : EntriesBySessionId)
+    {
+        Pair.Value->bIsListed = PassesFilter(*Pair.Value);
+        if (Pair.Value->bIsListed)
+        {
+            ListedEntries.Add(Pair.Value);
+        }
+    }
+    ListedEntries.Sort([this](const USessionBrowserEntry& A, const USessionBrowserEntry& B) { return IsListedBefore(A, B); });
+
+    if (SessionList)
+    {
+        SessionList->SetListItems(ListedEntries);
+    }
+}
+
+bool USessionBrowser::PassesFilter(const USessionBrowserEntry& Entry) const
+{
+    if (MaxPingMs > 0 && Entry.PingMs > MaxPingMs)
+    {
+        return false;
+    }
+    if (bHideFullSessions && Entry.MaxPlayers > 0 && Entry.NumPlayers >= Entry.MaxPlayers)
+    {
+        return false;
+    }
+    if (bHideEmptySessions && Entry.NumPlayers == 0)
+    {
+        return false;
+    }
+    // Compare the hashes first, like FSessionSearchSummary::HasMatchType
+    return MatchTypeFilter.IsEmpty() ||
+           (Entry.MatchTypeHash == MatchTypeFilterHash && Entry.MatchType.Equals(MatchTypeFilter, ESearchCase::IgnoreCase));
+}
+
+bool USessionBrowser::IsListedBefore(const USessionBrowserEntry& A, const USessionBrowserEntry& B) const
+{
+    int32 Order = 0;
+    switch (SortKey)
+    {
+        case ESessionBrowserSortKey::Ping:
+            Order = A.PingMs - B.PingMs;
+            break;
+        case ESessionBrowserSortKey::Occupancy:
+        {
+            // Compare the filled fractions without dividing
+            const int64 FilledA = int64(A.NumPlayers) * FMath::Max(B.MaxPlayers, 1);
+            const int64 FilledB = int64(B.NumPlayers) * FMath::Max(A.MaxPlayers, 1);
+            Order = FilledA < FilledB ? -1 : (FilledA > FilledB ? 1 : 0);
+            break;
+        }
+        case ESessionBrowserSortKey::MatchType:
+            Order = A.MatchType.Compare(B.MatchType, ESearchCase::IgnoreCase);
+            break;
+        case ESessionBrowserSortKey::OwnerName:
+            Order = A.OwnerName.Compare(B.OwnerName, ESearchCase::IgnoreCase);
+            break;
+    }
+    if (Order != 0)
+    {
+        return bSortDescending ? Order > 0 : Order < 0;
+    }
+    // Ties are ordered by session, so a session keeps its place among its equals from one search to the next
+    return A.SessionId.Compare(B.SessionId, ESearchCase::CaseSensitive) < 0;
+}
+
+bool USessionBrowser::AffectsListPosition(ESessionBrowserEntryChange Changes) const
+{
+    switch (SortKey)
+    {
+        case ESessionBrowserSortKey::Ping:
+            return EnumHasAnyFlags(Changes, ESessionBrowserEntryChange::Ping);
+        case ESessionBrowserSortKey::Occupancy:
+            return EnumHasAnyFlags(Changes, ESessionBrowserEntryChange::Players);
+        case ESessionBrowserSortKey::MatchType:
+            return EnumHasAnyFlags(Changes, ESessionBrowserEntryChange::MatchType);
+        case ESessionBrowserSortKey::OwnerName:
+            return EnumHasAnyFlags(Changes, ESessionBrowserEntryChange::OwnerName);
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SessionBrowserEntry.h"
+
+#include "SessionSearchSummary.h"
+
+ESessionBrowserEntryChange USessionBrowserEntry::UpdateFrom(const FSessionSearchSummary& Summary, int32 Row)
+{
+    ESessionBrowserEntryChange Changes = ESessionBrowserEntryChange::None;
+    ResultIndex = Row;
+    if (!Summary.GetSessionId(Row).Equals(SessionId, ESearchCase::CaseSensitive))
+    {
+        SessionId = FString(Summary.GetSessionId(Row));
+    }
+
+    if (PingMs != Summary.GetPingMs(Row))
+    {
+        PingMs = Summary.GetPingMs(Row);
+        Changes |= ESessionBrowserEntryChange::Ping;
+    }
+
+    const int32 NewMaxPlayers = Summary.GetMaxSlots(Row);
+    const int32 NewNumPlayers = FMath::Max(NewMaxPlayers - Summary.GetOpenSlots(Row), 0);
+    if (NumPlayers != NewNumPlayers || MaxPlayers != NewMaxPlayers)
+    {
+        NumPlayers = NewNumPlayers;
+        MaxPlayers = NewMaxPlayers;
+        Changes |= ESessionBrowserEntryChange::Players;
+    }
+
+    // The strings rarely change, compare them before copying them out of the summary
+    if (MatchTypeHash != Summary.GetMatchTypeHash(Row) || !Summary.GetMatchType(Row).Equals(MatchType))
+    {
+        MatchTypeHash = Summary.GetMatchTypeHash(Row);
+        MatchType = FString(Summary.GetMatchType(Row));
+        Changes |= ESessionBrowserEntryChange::MatchType;
+    }
+    if (!Summary.GetOwnerName(Row).Equals(OwnerName))
+    {
+        OwnerName = FString(Summary.GetOwnerName(Row));
+        Changes |= ESessionBrowserEntryChange::OwnerName;
+    }
+    return Changes;
+}
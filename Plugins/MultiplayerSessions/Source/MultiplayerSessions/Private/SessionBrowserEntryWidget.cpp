@@ -0,0 +1,67 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SessionBrowserEntryWidget.h"
+
+#include "Components/TextBlock.h"
+#include "SessionBrowserEntry.h"
+
+#define LOCTEXT_NAMESPACE "SessionBrowser"
+
+void USessionBrowserEntryWidget::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+    IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+    StopWatchingEntry();
+    Entry = Cast<USessionBrowserEntry>(ListItemObject);
+    if (Entry)
+    {
+        EntryChangedHandle = Entry->OnChanged.AddUObject(this, &ThisClass::OnEntryChanged);
+        Refresh(ESessionBrowserEntryChange::Ping | ESessionBrowserEntryChange::Players |
+                ESessionBrowserEntryChange::MatchType | ESessionBrowserEntryChange::OwnerName);
+    }
+}
+
+void USessionBrowserEntryWidget::NativeOnEntryReleased()
+{
+    StopWatchingEntry();
+    Entry = nullptr;
+    IUserObjectListEntry::NativeOnEntryReleased();
+}
+
+void USessionBrowserEntryWidget::OnEntryChanged(ESessionBrowserEntryChange Changes)
+{
+    Refresh(Changes);
+}
+
+void USessionBrowserEntryWidget::Refresh(ESessionBrowserEntryChange Changes)
+{
+    // Only the texts that changed, formatting them is most of the cost of a row
+    if (EnumHasAnyFlags(Changes, ESessionBrowserEntryChange::OwnerName) && OwnerNameText)
+    {
+        OwnerNameText->SetText(FText::FromString(Entry->OwnerName));
+    }
+    if (EnumHasAnyFlags(Changes, ESessionBrowserEntryChange::MatchType) && MatchTypeText)
+    {
+        MatchTypeText->SetText(FText::FromString(Entry->MatchType));
+    }
+    if (EnumHasAnyFlags(Changes, ESessionBrowserEntryChange::Players) && PlayersText)
+    {
+        PlayersText->SetText(FText::Format(
+            LOCTEXT("Players", "{0}/{1}"), FText::AsNumber(Entry->NumPlayers), FText::AsNumber(Entry->MaxPlayers)));
+    }
+    if (EnumHasAnyFlags(Changes, ESessionBrowserEntryChange::Ping) && PingText)
+    {
+        PingText->SetText(FText::Format(LOCTEXT("Ping", "{0} ms"), FText::AsNumber(Entry->PingMs)));
+    }
+}
+
+void USessionBrowserEntryWidget::StopWatchingEntry()
+{
+    if (Entry)
+    {
+        Entry->OnChanged.Remove(EntryChangedHandle);
+    }
+    EntryChangedHandle.Reset();
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,133 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SessionLatencyTracker.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.inl"
+
+static_assert(static_cast<int32>(ESessionOperation::Num) == 7, "Update FSessionLatencyTracker::NumOperations");
+
+CSV_DEFINE_CATEGORY(MultiplayerSessions, true);
+
+UE_TRACE_CHANNEL_DEFINE(MultiplayerSessionsChannel);
+
+UE_TRACE_EVENT_BEGIN(MultiplayerSessions, OperationLatency)
+    UE_TRACE_EVENT_FIELD(uint64, StartCycle)
+    UE_TRACE_EVENT_FIELD(uint64, EndCycle)
+    UE_TRACE_EVENT_FIELD(uint8, Operation)
+    UE_TRACE_EVENT_FIELD(bool, bWasSuccessful)
+UE_TRACE_EVENT_END()
+
+namespace
+{
+// Names of the CSV stats, one per operation in ESessionOperation order
+const char* const CsvStatNames[] = {"CreateMs", "UpdateMs", "FindMs", "CancelFindMs", "JoinMs", "DestroyMs", "StartMs"};
+static_assert(UE_ARRAY_COUNT(CsvStatNames) == static_cast<int32>(ESessionOperation::Num), "One CSV stat per operation");
+
+float GetPercentile(const TArray<float>& SortedSamples, float Percentile)
+{
+    const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+    return SortedSamples[Index];
+}
+
+FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpLatencyCommand(TEXT("MultiplayerSessions.DumpLatency"),
+    TEXT("Prints the p50, p95 and p99 latency of the last session operations of each kind"),
+    FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+        [](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+        {
+            const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+            if (const UMultiplayerSessionsSubsystem* Subsystem =
+                    GameInstance ? GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr)
+            {
+                Subsystem->GetLatencyTracker().Dump(Ar);
+            }
+        }));
+}    // namespace
+
+void FSessionLatencyTracker::Begin(ESessionOperation Operation)
+{
+    Operations[static_cast<int32>(Operation)].StartCycles = FPlatformTime::Cycles64();
+}
+
+float FSessionLatencyTracker::End(ESessionOperation Operation, bool bWasSuccessful)
+{
+    FOperationSamples& Samples = Operations[static_cast<int32>(Operation)];
+    if (Samples.StartCycles == 0)
+    {
+        return 0.f;
+    }
+    const uint64 StartCycles = Samples.StartCycles;
+    Samples.StartCycles = 0;
+    return Record(Operation, StartCycles, bWasSuccessful);
+}
+
+float FSessionLatencyTracker::Record(ESessionOperation Operation, uint64 StartCycles, bool bWasSuccessful)
+{
+    FOperationSamples& Samples = Operations[static_cast<int32>(Operation)];
+    const uint64 EndCycles = FPlatformTime::Cycles64();
+
+    const float LatencyMs = static_cast<float>(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles));
+    Samples.LatenciesMs[Samples.NextSample] = LatencyMs;
+    Samples.NextSample = (Samples.NextSample + 1) % WindowSize;
+    Samples.NumSamples = FMath::Min(Samples.NumSamples + 1, WindowSize);
+    Samples.NumFailures += bWasSuccessful ? 0 : 1;
+
+    UE_TRACE_LOG(MultiplayerSessions, OperationLatency, MultiplayerSessionsChannel)
+        << OperationLatency.StartCycle(StartCycles) << OperationLatency.EndCycle(EndCycles)
+        << OperationLatency.Operation(static_cast<uint8>(Operation)) << OperationLatency.bWasSuccessful(bWasSuccessful);
+
+#if CSV_PROFILER
+    FCsvProfiler::RecordCustomStat(CsvStatNames[static_cast<int32>(Operation)], CSV_CATEGORY_INDEX(MultiplayerSessions),
+        LatencyMs, ECsvCustomStatOp::Set);
+#endif
+    return LatencyMs;
+}
+
+void FSessionLatencyTracker::Dump(FOutputDevice& Ar) const
+{
+    TArray<float> SortedSamples;
+    for (int32 OperationIndex = 0; OperationIndex < NumOperations; ++OperationIndex)
+    {
+        const FOperationSamples& Samples = Operations[OperationIndex];
+        const TCHAR* Name = GetOperationName(static_cast<ESessionOperation>(OperationIndex));
+        if (Samples.NumSamples == 0)
+        {
+            Ar.Logf(TEXT("%-8s no samples"), Name);
+            continue;
+        }
+
+        SortedSamples.Reset();
+        SortedSamples.Append(Samples.LatenciesMs.GetData(), Samples.NumSamples);
+        SortedSamples.Sort();
+        Ar.Logf(TEXT("%-8s p50 %8.1f ms  p95 %8.1f ms  p99 %8.1f ms  (%d samples, %d failed since start)"), Name,
+            GetPercentile(SortedSamples, 0.50f), GetPercentile(SortedSamples, 0.95f), GetPercentile(SortedSamples, 0.99f),
+            Samples.NumSamples, Samples.NumFailures);
+    }
+}
+
+const TCHAR* FSessionLatencyTracker::GetOperationName(ESessionOperation Operation)
+{
+    switch (Operation)
+    {
+        case ESessionOperation::Create:
+            return TEXT("Create");
+        case ESessionOperation::Update:
+            return TEXT("Update");
+        case ESessionOperation::Find:
+            return TEXT("Find");
+        case ESessionOperation::CancelFind:
+            return TEXT("CancelFind");
+        case ESessionOperation::Join:
+            return TEXT("Join");
+        case ESessionOperation::Destroy:
+            return TEXT("Destroy");
+        case ESessionOperation::Start:
+            return TEXT("Start");
+        default:
+            return TEXT("Unknown");
+    }
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SessionRanker.h"
+
+#include "Async/ParallelFor.h"
+#include "OnlineSessionSettings.h"
+#include "SessionSearchSummary.h"
+
+void USessionRanker::RankSessions(
+    const FSessionSearchSummary& Summary, const TArray<int32>& Candidates, TArray<int32>& OutRanked) const
+{
+    OutRanked.Reset();
+
+    // Score every candidate, sessions that can't be joined get no score
+    TArray<TOptional<float>> Scores;
+    Scores.SetNum(Candidates.Num());
+    ParallelFor(
+        Candidates.Num(),
+        [&](int32 CandidateIndex)
+        {
+            const int32 ResultIndex = Candidates[CandidateIndex];
+            if (ResultIndex >= 0 && ResultIndex < Summary.Num() && IsViable(Summary, ResultIndex))
+            {
+                Scores[CandidateIndex] = ScoreSession(Summary, ResultIndex);
+            }
+        },
+        Candidates.Num() < ParallelScoringThreshold);
+
+    // Sort the viable candidates by score, keeping the search order between equal scores
+    TArray<TPair<float, int32>> Ranked;
+    Ranked.Reserve(Candidates.Num());
+    for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+    {
+        if (Scores[CandidateIndex].IsSet())
+        {
+            Ranked.Emplace(Scores[CandidateIndex].GetValue(), Candidates[CandidateIndex]);
+        }
+    }
+    Ranked.StableSort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+
+    OutRanked.Reserve(Ranked.Num());
+    for (const TPair<float, int32>& Entry : Ranked)
+    {
+        OutRanked.Add(Entry.Value);
+    }
+}
+
+int32 USessionRanker::PickGoodEnoughSession(const FSessionSearchSummary& Summary, const TArray<int32>& Candidates) const
+{
+    // Batches are small, scoring them on this thread is cheaper than going wide
+    int32 BestResult = INDEX_NONE;
+    float BestScore = 0.f;
+    for (const int32 ResultIndex : Candidates)
+    {
+        if (ResultIndex < 0 || ResultIndex >= Summary.Num() || !IsViable(Summary, ResultIndex))
+        {
+            continue;
+        }
+        const float Score = ScoreSession(Summary, ResultIndex);
+        if (BestResult == INDEX_NONE || Score > BestScore)
+        {
+            BestResult = ResultIndex;
+            BestScore = Score;
+        }
+    }
+    return BestResult != INDEX_NONE && BestScore >= GoodEnoughScore ? BestResult : INDEX_NONE;
+}
+
+bool USessionRanker::IsViable(const FSessionSearchSummary& Summary, int32 Row) const
+{
+    if (!Summary.IsValid(Row) || Summary.GetOpenSlots(Row) <= 0)
+    {
+        return false;
+    }
+    // An unknown ping is reported as MAX_QUERY_PING, we don't rule those sessions out
+    const int32 PingMs = Summary.GetPingMs(Row);
+    return PingMs >= MAX_QUERY_PING || PingMs <= MaxPingMs;
+}
+
+float USessionRanker::ScoreSession(const FSessionSearchSummary& Summary, int32 Row) const
+{
+    // Sessions with an unknown ping score as if they were at the highest ping we accept
+    const int32 PingMs = Summary.GetPingMs(Row);
+    const float Ping = PingMs >= MAX_QUERY_PING ? MaxPingMs : PingMs;
+    const float PingScore = MaxPingMs > 0 ? 1.f - FMath::Clamp(Ping / MaxPingMs, 0.f, 1.f) : 0.f;
+
+    const int32 OpenSlots = Summary.GetOpenSlots(Row);
+    const float OpenSlotsScore = DesiredOpenSlots > 0 ? FMath::Min(OpenSlots, DesiredOpenSlots) / float(DesiredOpenSlots) : 1.f;
+
+    const int32 MaxSlots = Summary.GetMaxSlots(Row);
+    const float FillRate = MaxSlots > 0 ? FMath::Clamp(float(MaxSlots - OpenSlots) / MaxSlots, 0.f, 1.f) : 0.f;
+
+    return PingWeight * PingScore + OpenSlotsWeight * OpenSlotsScore + FillRateWeight * FillRate;
+}
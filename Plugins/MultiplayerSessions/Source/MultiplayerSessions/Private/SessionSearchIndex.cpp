@@ -0,0 +1,27 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SessionSearchIndex.h"
+
+void FSessionSearchIndex::Build(const FSessionSearchSummary& Summary)
+{
+    ByMatchType.Reset();
+
+    for (int32 Index = 0; Index < Summary.Num(); ++Index)
+    {
+        const FStringView MatchType = Summary.GetMatchType(Index);
+        if (MatchType.IsEmpty())
+        {
+            continue;
+        }
+
+        ByMatchType.FindOrAdd(FString(MatchType)).Add(Index);
+    }
+}
+
+const TArray<int32>& FSessionSearchIndex::Find(const FString& MatchType) const
+{
+    static const TArray<int32> NoResults;
+
+    const TArray<int32>* ResultIndices = ByMatchType.Find(MatchType);
+    return ResultIndices ? *ResultIndices : NoResults;
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SessionSearchSummary.h"
+
+#include "Misc/Crc.h"
+#include "Misc/StringBuilder.h"
+#include "OnlineSessionSettings.h"
+#include "SessionSearchIndex.h"
+
+void FSessionSearchSummary::Append(const TArray<FOnlineSessionSearchResult>& SearchResults)
+{
+    const int32 FirstRow = Num();
+    const int32 NumRows = SearchResults.Num();
+    if (NumRows <= FirstRow)
+    {
+        return;
+    }
+
+    const int32 NumNewRows = NumRows - FirstRow;
+    ValidRows.Reserve(NumRows);
+    SessionIdHashes.Reserve(NumRows);
+    PingsMs.Reserve(NumRows);
+    OpenSlots.Reserve(NumRows);
+    MaxSlots.Reserve(NumRows);
+    MatchTypeHashes.Reserve(NumRows);
+    SessionIds.Reserve(NumRows);
+    OwnerNames.Reserve(NumRows);
+    MatchTypes.Reserve(NumRows);
+    // Ids and names are short, a guess of 32 characters per row saves most of the arena regrowth
+    StringArena.Reserve(StringArena.Num() + NumNewRows * 32);
+
+    // Reused for every result, so each string is converted once per session and never per lookup
+    FString SessionId;
+    FString MatchType;
+    for (int32 Row = FirstRow; Row < NumRows; ++Row)
+    {
+        const FOnlineSessionSearchResult& SearchResult = SearchResults[Row];
+        const FOnlineSession& Session = SearchResult.Session;
+
+        ValidRows.Add(SearchResult.IsValid());
+        PingsMs.Add(SearchResult.PingInMs);
+        OpenSlots.Add(Session.NumOpenPublicConnections);
+        MaxSlots.Add(Session.SessionSettings.NumPublicConnections);
+
+        if (Session.SessionInfo.IsValid())
+        {
+            const FUniqueNetId& Id = Session.SessionInfo->GetSessionId();
+            SessionIdHashes.Add(GetTypeHash(Id));
+            SessionId = Id.ToString();
+        }
+        else
+        {
+            SessionIdHashes.Add(0);
+            SessionId.Reset();
+        }
+        SessionIds.Add(AddString(SessionId));
+        OwnerNames.Add(AddString(Session.OwningUserName));
+
+        MatchType.Reset();
+        if (const FOnlineSessionSetting* Setting = Session.SessionSettings.Settings.Find(SETTING_MATCHTYPE))
+        {
+            Setting->Data.GetValue(MatchType);
+        }
+        MatchTypeHashes.Add(HashMatchType(MatchType));
+        MatchTypes.Add(AddString(MatchType));
+    }
+}
+
+void FSessionSearchSummary::Reset()
+{
+    ValidRows.Reset();
+    SessionIdHashes.Reset();
+    PingsMs.Reset();
+    OpenSlots.Reset();
+    MaxSlots.Reset();
+    MatchTypeHashes.Reset();
+    SessionIds.Reset();
+    OwnerNames.Reset();
+    MatchTypes.Reset();
+    StringArena.Reset();
+}
+
+uint32 FSessionSearchSummary::HashMatchType(FStringView MatchType)
+{
+    // Match types are short, the builder only allocates for unusually long ones
+    TStringBuilder<64> Lowered;
+    for (const TCHAR Char : MatchType)
+    {
+        Lowered.AppendChar(FChar::ToLower(Char));
+    }
+    return FCrc::StrCrc32(Lowered.ToString());
+}
+
+FSessionSearchSummary::FArenaString FSessionSearchSummary::AddString(FStringView String)
+{
+    const FArenaString ArenaString{StringArena.Num(), String.Len()};
+    StringArena.Append(String.GetData(), String.Len());
+    return ArenaString;
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SessionTelemetry.h"
+
+#if WITH_SESSION_TELEMETRY
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "MultiplayerSessions.h"
+#include "MultiplayerSessionsSubsystem.h"
+
+namespace
+{
+FAutoConsoleCommand FlushTelemetryCommand(TEXT("MultiplayerSessions.FlushTelemetry"),
+    TEXT("Writes the session operations recorded since the last flush to Saved/Logs/SessionTelemetry.csv"),
+    FConsoleCommandDelegate::CreateLambda(
+        []()
+        {
+            const int32 NumWritten = FSessionTelemetry::Get().Flush();
+            UE_LOG(LogMultiplayerSessions, Log, TEXT("Wrote %d session events to %s"), NumWritten,
+                *FSessionTelemetry::Get().GetFilePath());
+        }));
+}    // namespace
+
+FSessionTelemetry& FSessionTelemetry::Get()
+{
+    static FSessionTelemetry Telemetry;
+    return Telemetry;
+}
+
+void FSessionTelemetry::Record(const FSessionTelemetryEvent& Event)
+{
+    const uint64 Index = NextWrite.fetch_add(1, std::memory_order_relaxed);
+    FSlot& Slot = Slots[Index & (Capacity - 1)];
+
+    // Odd while writing, so a flush reading the slot at the same time drops what it read
+    Slot.Sequence.store(2 * Index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot.Event = Event;
+    Slot.Sequence.store(2 * Index + 2, std::memory_order_release);
+}
+
+int32 FSessionTelemetry::Flush()
+{
+    FScopeLock Lock(&FlushLock);
+
+    const uint64 End = NextWrite.load(std::memory_order_acquire);
+    if (End - NextRead > Capacity)
+    {
+        // Overwritten before we got to them
+        NumDropped += End - NextRead - Capacity;
+        NextRead = End - Capacity;
+    }
+    if (NextRead == End)
+    {
+        return 0;
+    }
+
+    // The wall clock time of the events, from how long ago they were recorded
+    const double NowSeconds = FPlatformTime::Seconds();
+    const FDateTime NowUtc = FDateTime::UtcNow();
+
+    FString Lines;
+    Lines.Reserve(static_cast<int32>(End - NextRead) * 96);
+    if (!bFileHasHeader && IFileManager::Get().FileSize(*GetFilePath()) <= 0)
+    {
+        Lines += TEXT("TimeUtc,Operation,Session,Success,Result,DurationMs,NumResults\n");
+    }
+
+    int32 NumWritten = 0;
+    for (; NextRead < End; ++NextRead)
+    {
+        const FSlot& Slot = Slots[NextRead & (Capacity - 1)];
+        const uint64 Published = 2 * NextRead + 2;
+        const uint64 SequenceBefore = Slot.Sequence.load(std::memory_order_acquire);
+        if (SequenceBefore < Published)
+        {
+            // Still being written, it goes out with the next flush
+            break;
+        }
+
+        const FSessionTelemetryEvent Event = Slot.Event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (SequenceBefore != Published || Slot.Sequence.load(std::memory_order_relaxed) != Published)
+        {
+            // Overwritten by an event recorded a whole ring later
+            ++NumDropped;
+            continue;
+        }
+
+        const FDateTime TimeUtc = NowUtc - FTimespan::FromSeconds(NowSeconds - Event.Time);
+        const TCHAR* Result = Event.Operation == ESessionOperation::Join
+                                  ? LexToString(static_cast<EOnJoinSessionCompleteResult::Type>(Event.ResultCode))
+                                  : TEXT("");
+        Lines += FString::Printf(TEXT("%s,%s,%s,%d,%s,%.1f,%d\n"), *TimeUtc.ToIso8601(),
+            FSessionLatencyTracker::GetOperationName(Event.Operation), *Event.SessionName.ToString(),
+            Event.bWasSuccessful ? 1 : 0, Result, Event.DurationMs, Event.NumResults);
+        ++NumWritten;
+    }
+
+    if (NumWritten > 0)
+    {
+        const TUniquePtr<FArchive> File(
+            IFileManager::Get().CreateFileWriter(*GetFilePath(), FILEWRITE_Append | FILEWRITE_AllowRead));
+        if (File)
+        {
+            FTCHARToUTF8 Utf8Lines(*Lines);
+            File->Serialize(const_cast<ANSICHAR*>(Utf8Lines.Get()), Utf8Lines.Length());
+            bFileHasHeader = true;
+        }
+        else
+        {
+            UE_LOG(LogMultiplayerSessions, Warning, TEXT("Failed to open %s, %d session events lost"), *GetFilePath(),
+                NumWritten);
+        }
+    }
+    return NumWritten;
+}
+
+FString FSessionTelemetry::GetFilePath() const
+{
+    return FPaths::ProjectLogDir() / TEXT("SessionTelemetry.csv");
+}
+
+#endif    // WITH_SESSION_TELEMETRY
@@ -13,6 +13,7 @@ class UButton;
 
 /**
  * UMenu class is a user interface widget that provides functionality for hosting and joining multiplayer sessions.
+ * It is meant to be created once and shown again with MenuSetup, see UMenuManagerSubsystem.
  */
 UCLASS()
 class MULTIPLAYERSESSIONS_API UMenu : public UUserWidget
@@ -29,6 +30,9 @@ public:
     void MenuSetup(int32 NumberOfPublicConnections = 4, FString TypeOfMatch = FString(TEXT("FreeForAll")),
         FString LobbyPath = FString(TEXT("/Game/Maps/Lobby")));
 
+    /** Takes the menu off screen, unbinds it from the subsystem and gives the input back to the game. */
+    void MenuTearDown();
+
 protected:
     /**
      * Initializes the widget. This function is called when the widget is constructed.
@@ -45,6 +49,8 @@ protected:
     // not UFUNCTION() because the delegate is not dynamic
     void OnFindSessions(const TArray<FOnlineSessionSearchResult>& SearchResults, bool bWasSuccessful);
     // not UFUNCTION() because the delegate is not dynamic
+    void OnFindSessionsBatch(const TArray<FOnlineSessionSearchResult>& SearchResults, int32 FirstNewResult);
+    // not UFUNCTION() because the delegate is not dynamic
     void OnJoinSession(EOnJoinSessionCompleteResult::Type Result);
     UFUNCTION()
     void OnDestroySession(bool bWasSuccessful);
@@ -72,13 +78,22 @@ private:
     UFUNCTION()
     void JoinButtonClicked();
 
-    void MenuTearDown();
+    // Bound while the menu is on screen, once however many times it is shown
+    void BindSubsystemDelegates();
+    void UnbindSubsystemDelegates();
 
     /** Subsystem for handling multiplayer sessions. */
     UPROPERTY()
     UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem;
 
     int32 NumPublicConnections{4};
+    // Also the size of the prefetched query, so joining is served from the prefetched results
+    int32 MaxSearchResults{10000};
     FString MatchType{TEXT("FreeForAll")};
     FString PathToLobby{TEXT("")};
+    FString LobbyMapPath{TEXT("")};
+    // Whether the player clicked Join. The searches and joins of a session browser also come through the subsystem
+    // delegates, the menu only joins and travels for its own
+    bool bJoinRequested = false;
+    bool bSubsystemDelegatesBound = false;
 };
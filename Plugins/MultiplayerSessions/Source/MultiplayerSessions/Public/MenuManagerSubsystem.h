@@ -0,0 +1,64 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "MenuManagerSubsystem.generated.h"
+
+class UMenu;
+struct FStreamableHandle;
+
+/**
+ * Owns the main menu. The menu widget class is soft referenced and loaded in the background when the game starts, the
+ * widget is created once and shown again every time the player comes back to the menu, e.g. after a match, instead of
+ * being loaded and built again. Call ShowMenu rather than creating WBP_Menu and calling UMenu::MenuSetup.
+ * The widget class is read from the [/Script/MultiplayerSessions.MenuManagerSubsystem] section of the Game config.
+ */
+UCLASS(Config = Game)
+class MULTIPLAYERSESSIONS_API UMenuManagerSubsystem : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /**
+     * Shows the menu, right away if its class is loaded, otherwise as soon as it is.
+     * Showing the menu while it is on screen only changes its settings.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Menu")
+    void ShowMenu(int32 NumberOfPublicConnections = 4, FString TypeOfMatch = FString(TEXT("FreeForAll")),
+        FString LobbyPath = FString(TEXT("/Game/Maps/Lobby")));
+
+    /** Takes the menu off screen and gives the input back to the game. The widget is kept for the next ShowMenu. */
+    UFUNCTION(BlueprintCallable, Category = "Menu")
+    void HideMenu();
+
+    UFUNCTION(BlueprintPure, Category = "Menu")
+    bool IsMenuVisible() const;
+
+protected:
+    /** Widget blueprint of the menu */
+    UPROPERTY(Config)
+    TSoftClassPtr<UMenu> MenuClass{FSoftObjectPath(TEXT("/MultiplayerSessions/WBP_Menu.WBP_Menu_C"))};
+
+private:
+    void OnMenuClassLoaded();
+    /** The menu widget, created the first time it is shown. Null until then, and while the class is loading. */
+    UMenu* GetOrCreateMenu();
+
+    UPROPERTY(Transient)
+    TObjectPtr<UMenu> Menu;
+
+    TSharedPtr<FStreamableHandle> MenuClassHandle;
+
+    // ShowMenu was called before the class was loaded, it is shown with these settings once it is
+    bool bShowPending = false;
+    int32 PendingNumPublicConnections{4};
+    FString PendingMatchType;
+    FString PendingLobbyPath;
+};
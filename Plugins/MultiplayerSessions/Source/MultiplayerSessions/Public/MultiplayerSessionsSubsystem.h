@@ -3,11 +3,21 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Containers/Ticker.h"
 #include "Interfaces/OnlineSessionInterface.h"
+#include "SessionLatencyTracker.h"
+#include "SessionSearchIndex.h"
+#include "SessionSearchSummary.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 
 #include "MultiplayerSessionsSubsystem.generated.h"
 
+class FNamedOnlineSession;
+class UPackage;
+class USessionRanker;
+class UWorld;
+
 /**
  * UMultiplayerSessionsSubsystem class is a game instance subsystem that provides functionality for handling multiplayer sessions.
  */
@@ -34,10 +44,122 @@ DECLARE_MULTICAST_DELEGATE_TwoParams(
 DECLARE_MULTICAST_DELEGATE_OneParam(FMultiplayerOnJoinSessionComplete, EOnJoinSessionCompleteResult::Type Result);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnDestroySessionComplete, bool, bWasSuccessful);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnStartSessionComplete, bool, bWasSuccessful);
+DECLARE_MULTICAST_DELEGATE_TwoParams(
+    FMultiplayerOnFindSessionsBatch, const TArray<FOnlineSessionSearchResult>& SearchResults, int32 FirstNewResult);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnCancelFindSessionsComplete, bool, bWasSuccessful);
+
+// Note, the find, join and batch delegates are not dynamic because they use parameters that are not supported by dynamic
+// delegates.
+
+/**
+ * The operations the subsystem runs on the session interface. Only one operation of each kind is in flight at a time on
+ * a named session. Find and CancelFind are not tied to a session, only one of each is in flight at all.
+ */
+enum class ESessionOperation : uint8
+{
+    Create,
+    Update,
+    Find,
+    CancelFind,
+    Join,
+    Destroy,
+    Start,
+    Num
+};
+
+/**
+ * The delegates of one named session, broadcast with the results of the operations on it.
+ */
+struct FMultiplayerSessionDelegates
+{
+    FMultiplayerOnCreateSessionComplete OnCreateSessionComplete;
+    FMultiplayerOnJoinSessionComplete OnJoinSessionComplete;
+    FMultiplayerOnDestroySessionComplete OnDestroySessionComplete;
+    FMultiplayerOnStartSessionComplete OnStartSessionComplete;
+};
+
+/**
+ * What the subsystem keeps for one named session: its delegates, the operations in flight on it and what they carry
+ * from one step to the next.
+ */
+struct FMultiplayerSessionState
+{
+    FName SessionName;
+    FMultiplayerSessionDelegates Delegates;
+
+    // A bit per ESessionOperation in flight on the session
+    uint8 InFlightOperations{0};
+    // Cycles64 when each operation in flight started, for the latency tracker
+    TStaticArray<uint64, static_cast<int32>(ESessionOperation::Num)> OperationStartCycles{InPlace, 0};
+
+    // The last session settings used to create the session
+    TSharedPtr<FOnlineSessionSettings> LastSessionSettings;
+    // The settings of the create waiting for the old session to be destroyed. The latest settings win if CreateSession
+    // is called again before the old session is destroyed
+    bool bCreateSessionOnDestroy{false};
+    int32 LastNumPublicConnections{0};
+    FString LastMatchType;
+    FString LastMapPath;
+    // Public connections added by the update in flight, the open ones only change once the backend accepted it
+    int32 PendingUpdateSlotDelta{0};
+
+    // Join failover: the sessions a join goes through, the best one first. They are copied, so a new search doesn't
+    // change them
+    TArray<FOnlineSessionSearchResult> JoinCandidates;
+    int32 NextJoinCandidate{0};
+    FTSTicker::FDelegateHandle JoinAttemptTimeoutHandle;
+    // A join timed out, the next candidate is tried once the session it left behind is destroyed
+    bool bJoinNextCandidateOnDestroy{false};
+    // Joins that timed out and haven't completed yet. The session interface completes the joins in order, so the next
+    // completions are theirs and are dropped rather than taken for the one of the join in flight
+    int32 NumAbandonedJoins{0};
+    // The next candidate waits for the last abandoned join to complete, or for as long again as the timeout
+    bool bWaitForAbandonedJoin{false};
+};
+
+/**
+ * Identifies a session query. FindSessions calls that build the same query share one cache entry.
+ */
+struct FSessionSearchCacheKey
+{
+    bool bIsLanQuery{false};
+    bool bSearchPresence{true};
+    int32 MaxSearchResults{0};
+    FString MatchType;
+    // Sorted by name, so the same attributes given in a different order make the same key
+    TArray<TPair<FName, FString>> ExtraQuerySettings;
 
-// Note, the second and the third delegates are not dynamic because they use parameters that are not supported by dynamic delegates.
+    bool operator==(const FSessionSearchCacheKey& Other) const
+    {
+        return bIsLanQuery == Other.bIsLanQuery && bSearchPresence == Other.bSearchPresence &&
+               MaxSearchResults == Other.MaxSearchResults && MatchType == Other.MatchType &&
+               ExtraQuerySettings == Other.ExtraQuerySettings;
+    }
+
+    friend uint32 GetTypeHash(const FSessionSearchCacheKey& Key)
+    {
+        uint32 Hash = HashCombine(GetTypeHash(Key.MaxSearchResults), (Key.bIsLanQuery ? 1u : 0u) | (Key.bSearchPresence ? 2u : 0u));
+        Hash = HashCombine(Hash, GetTypeHash(Key.MatchType));
+        for (const TPair<FName, FString>& Setting : Key.ExtraQuerySettings)
+        {
+            Hash = HashCombine(Hash, HashCombine(GetTypeHash(Setting.Key), GetTypeHash(Setting.Value)));
+        }
+        return Hash;
+    }
+};
 
-UCLASS()
+/**
+ * A completed search kept in the session search cache.
+ */
+struct FCachedSessionSearch
+{
+    TSharedPtr<FOnlineSessionSearch> Search;
+    TSharedPtr<const FSessionSearchSummary> Summary;
+    TSharedPtr<const FSessionSearchIndex> Index;
+    double CompletionTime{0.0};
+};
+
+UCLASS(Config = Game)
 class MULTIPLAYERSESSIONS_API UMultiplayerSessionsSubsystem : public UGameInstanceSubsystem
 {
     GENERATED_BODY()
@@ -45,25 +167,164 @@ class MULTIPLAYERSESSIONS_API UMultiplayerSessionsSubsystem : public UGameInstan
 public:
     UMultiplayerSessionsSubsystem();
 
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
     //
     // Functions to handle session functionalities
     // The Menu class will call these
     //
+    // A request for an operation that is already in flight is coalesced with it: the caller gets the result of the
+    // running operation through the delegates. A FindSessions for a different query replaces the queued one and runs
+    // as soon as the current search completes.
+    //
+    // Several named sessions can be managed at once, e.g. a party session that stays up while its members move from
+    // one game session to the next. Each has its own operations in flight and its own delegates, see
+    // GetSessionDelegates. Without a name, the functions act on the game session, NAME_GameSession.
+    //
+
+    /**
+     * Creates a session. If we are already hosting one that only differs by the number of connections or the match type,
+     * it is updated in place instead. Otherwise it is destroyed first and the new session is created once that completed.
+     * Either way, the result is broadcast through MultiplayerOnCreateSessionComplete.
+     * On a dedicated server the session is created by the server itself, without a local player, and is advertised as
+     * a dedicated session.
+     * @param MapPath The map the session is played on, e.g. "/Game/Maps/Lobby". It is advertised to the players joining,
+     * and it starts loading right away, so the load overlaps with the backend creating the session
+     * @param SessionName Give the sessions that are not played in, like a party session, a match type of their own, so
+     * the game searches don't find them
+     */
+    void CreateSession(int32 NumPublicConnections, FString MatchType, const FString& MapPath = FString(),
+        FName SessionName = NAME_GameSession);
+    /**
+     * Searches for sessions. The match type and the extra settings are sent to the backend with the query, so it only
+     * returns the sessions advertising them. An empty match type searches for every match type.
+     */
+    void FindSessions(
+        int32 MaxSearchResults, const FString& MatchType = FString(), const TMap<FName, FString>& ExtraQuerySettings = {});
+    /**
+     * Cancels the search in flight. Its results are dropped and MultiplayerOnFindSessionsComplete is not broadcast for it,
+     * MultiplayerOnCancelFindSessionsComplete is once the backend confirmed the cancellation.
+     * @return false if no search was running or the backend can't cancel it
+     */
+    bool CancelFindSessions();
+    /**
+     * Joins the given session. A join that doesn't complete within JoinAttemptTimeout seconds fails.
+     * The result is broadcast through MultiplayerOnJoinSessionComplete.
+     */
+    void JoinSession(const FOnlineSessionSearchResult& SearchResult, FName SessionName = NAME_GameSession);
+    /**
+     * Joins the best ranked session with the given match type from the last broadcast search results. If the join fails
+     * because the session is full, gone or doesn't answer, the next ranked candidates are tried without searching again,
+     * up to MaxJoinAttempts. MultiplayerOnJoinSessionComplete is only broadcast with a failure once every one failed.
+     * @return false if there is no viable session to join, nothing is broadcast then
+     */
+    bool JoinBestSession(const FString& MatchType, FName SessionName = NAME_GameSession);
+    /**
+     * Joins a session of the search still running, meant for MultiplayerOnFindSessionsBatch with the index returned by
+     * FindGoodEnoughSearchResult. That session is tried first, then the other sessions with the match type found so far,
+     * best ranked first, with the same failover as JoinBestSession.
+     * @return false if the index is not in the last broadcast search results, nothing is broadcast then
+     */
+    bool JoinSearchResult(int32 ResultIndex, const FString& MatchType, FName SessionName = NAME_GameSession);
+    void DestroySession(FName SessionName = NAME_GameSession);
+    void StartSession(FName SessionName = NAME_GameSession);
+
+    /** Gets the address to travel to for the session we joined, from the session interface the subsystem uses. */
+    bool GetResolvedConnectString(FString& OutConnectString, FName SessionName = NAME_GameSession) const;
+
+    /** Number of public connections of the session we are in, 0 if we are in none. */
+    int32 GetNumPublicConnections(FName SessionName = NAME_GameSession) const;
+
+    /**
+     * The delegates of a named session. The ones of the game session are also broadcast through the MultiplayerOn...
+     * delegates below, which only the game session uses.
+     */
+    FMultiplayerSessionDelegates& GetSessionDelegates(FName SessionName);
+
+    /**
+     * Starts loading a map and its hard references in the background, so travelling to it doesn't load it from scratch.
+     * The map is kept in memory until the next map is loaded. Only the last map asked for is kept.
+     * Creating and joining a session preload the map of the session, see bPreloadSessionMaps.
+     */
+    void PreloadMap(const FString& MapPath);
+
+    /**
+     * Whether an operation of the given kind is running on the session interface for the given session.
+     * The session name is ignored for Find and CancelFind.
+     */
+    bool IsOperationInFlight(ESessionOperation Operation, FName SessionName = NAME_GameSession) const;
+
+    /** Latency of the operations run by this subsystem, see FSessionLatencyTracker. */
+    const FSessionLatencyTracker& GetLatencyTracker() const { return LatencyTracker; }
+
+    /** Drops every cached search result, so the next FindSessions goes to the backend. */
+    void InvalidateSessionSearchCache();
+
+    /**
+     * Keeps the cached results of a query warm while the player has not asked for them yet, e.g. while the menu is up.
+     * A background search starts right away and is refreshed every SessionPrefetchInterval seconds, backing off up to
+     * SessionPrefetchMaxInterval. A FindSessions for the same query is then served from the cache.
+     * Does nothing unless bEnableSessionPrefetch is set.
+     */
+    void StartSessionPrefetch(int32 MaxSearchResults, const FString& MatchType = FString());
+    /** Stops refreshing the prefetched query. A prefetch search already running still completes into the cache. */
+    void StopSessionPrefetch();
+
+    /**
+     * Summary of the search results last broadcast through MultiplayerOnFindSessionsBatch or
+     * MultiplayerOnFindSessionsComplete, row i summarizes SearchResults[i]. Read the fields from here rather than from the
+     * results, they are only converted once per search.
+     */
+    const FSessionSearchSummary& GetSearchSummary() const;
+
+    /**
+     * Returns a result of the search last broadcast, for the listeners that only kept its index, e.g. a row of the summary.
+     * @return nullptr if the index is out of range
+     */
+    const FOnlineSessionSearchResult* GetSearchResult(int32 ResultIndex) const;
+
+    /**
+     * Returns the indices into the last broadcast search results of the sessions with the given match type.
+     * Backends that ignore the query settings, like the NULL one, still return every match type, so this must be used to
+     * pick the sessions out of the results.
+     */
+    const TArray<int32>& FindSearchResultsByMatchType(const FString& MatchType) const;
+
+    /**
+     * Ranks the sessions with the given match type in the last broadcast search results, using the session ranker.
+     * @return The indices into the search results of the sessions worth joining, the best one first
+     */
+    const TArray<int32>& RankSearchResults(const FString& MatchType);
+
+    /**
+     * Looks for a session worth joining without waiting for the rest of the search, meant for MultiplayerOnFindSessionsBatch.
+     * Only the last broadcast results from FirstResult on with the given match type are looked at, an empty match type
+     * takes any.
+     * @return The index into the search results of the best of them if the ranker finds it good enough, INDEX_NONE otherwise
+     */
+    int32 FindGoodEnoughSearchResult(int32 FirstResult, const FString& MatchType);
 
-    void CreateSession(int32 NumPublicConnections, FString MatchType);
-    void FindSessions(int32 MaxSearchResults);
-    void JoinSession(const FOnlineSessionSearchResult& SearchResult);
-    void DestroySession();
-    void StartSession();
+    /** Returns the ranker used to order the search results, creating it on first use. */
+    USessionRanker* GetSessionRanker();
 
     //
     // Our own custom delegates for the Menu class to bind callbacks to
+    // The ones with a session result are only broadcast for the game session
     //
     FMultiplayerOnCreateSessionComplete MultiplayerOnCreateSessionComplete;
     FMultiplayerOnFindSessionComplete MultiplayerOnFindSessionsComplete;
     FMultiplayerOnJoinSessionComplete MultiplayerOnJoinSessionComplete;
     FMultiplayerOnDestroySessionComplete MultiplayerOnDestroySessionComplete;
     FMultiplayerOnStartSessionComplete MultiplayerOnStartSessionComplete;
+    FMultiplayerOnCancelFindSessionsComplete MultiplayerOnCancelFindSessionsComplete;
+
+    /**
+     * Broadcast while a search runs on the backend, every time it delivered new results. SearchResults holds every result
+     * received so far and the new ones start at FirstNewResult. Results served from the cache only come through
+     * MultiplayerOnFindSessionsComplete.
+     */
+    FMultiplayerOnFindSessionsBatch MultiplayerOnFindSessionsBatch;
 
 protected:
     //
@@ -72,7 +333,9 @@ protected:
     //
 
     void OnCreateSessionComplete(FName SessionName, bool bWasSuccessful);
+    void OnUpdateSessionComplete(FName SessionName, bool bWasSuccessful);
     void OnFindSessionsComplete(bool bWasSuccessful);
+    void OnCancelFindSessionsComplete(bool bWasSuccessful);
     void OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result);
     void OnDestroySessionComplete(FName SessionName, bool bWasSuccessful);
     void OnStartSessionComplete(FName SessionName, bool bWasSuccessful);
@@ -80,9 +343,193 @@ protected:
 private:
     IOnlineSessionPtr SessionInterface;
 
-    // The last session settings used to create a session
-    TSharedPtr<FOnlineSessionSettings> LastSessionSettings;
+    // Seconds between two writes of the session telemetry to its file, see FSessionTelemetry. 0 only writes it when the
+    // game instance shuts down
+    UPROPERTY(Config)
+    float TelemetryFlushInterval{30.f};
+
+    bool FlushTelemetry(float DeltaTime);
+    FTSTicker::FDelegateHandle TelemetryFlushHandle;
+
+    // Replaces the online subsystem session interface with FMockOnlineSession, to benchmark and test without a backend.
+    // Can also be enabled with -MockSessions on the command line
+    UPROPERTY(Config)
+    bool bUseMockSessionBackend{false};
+
+    // Adds our internal callbacks to the session interface delegate lists and keeps their handles.
+    // They stay bound until Deinitialize, so the delegate lists don't grow with every operation
+    void BindSessionInterfaceDelegates();
+    void UnbindSessionInterfaceDelegates();
+
+    // Marks a search operation (Find, CancelFind) as in flight. Returns false if an operation of the same kind already is
+    bool BeginOperation(ESessionOperation Operation);
+    // Marks a search operation as completed. Returns false if it wasn't in flight, i.e. the completion is not for us.
+    // The operation is recorded in the session telemetry with the number of search results
+    bool EndOperation(ESessionOperation Operation, bool bWasSuccessful = false, int32 NumResults = 0);
+    // Same for the operations on a named session. ResultCode is the EOnJoinSessionCompleteResult of a join
+    bool BeginOperation(FMultiplayerSessionState& Session, ESessionOperation Operation);
+    bool EndOperation(
+        FMultiplayerSessionState& Session, ESessionOperation Operation, bool bWasSuccessful = false, uint8 ResultCode = 0);
+
+    // The search operations in flight, the ones on a session are in its FMultiplayerSessionState
+    uint8 InFlightOperations{0};
+    // Times every operation from BeginOperation to EndOperation
+    FSessionLatencyTracker LatencyTracker;
+    static_assert(static_cast<uint8>(ESessionOperation::Num) <= 8, "InFlightOperations has a bit per operation");
+
+    // The state of every named session we operated on. Allocated one by one, so a state stays put while a listener
+    // starts an operation on another session
+    TMap<FName, TUniquePtr<FMultiplayerSessionState>> Sessions;
+
+    FMultiplayerSessionState& GetSessionState(FName SessionName);
+    const FMultiplayerSessionState* FindSessionState(FName SessionName) const;
+
+    // Broadcast the delegates of the session, and the MultiplayerOn... ones for the game session
+    void BroadcastCreateSessionComplete(FName SessionName, bool bWasSuccessful);
+    void BroadcastJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result);
+    void BroadcastDestroySessionComplete(FName SessionName, bool bWasSuccessful);
+    void BroadcastStartSessionComplete(FName SessionName, bool bWasSuccessful);
+
+    TSharedRef<FOnlineSessionSettings> MakeSessionSettings(
+        int32 NumPublicConnections, const FString& MatchType, const FString& MapPath) const;
+    // Whether the existing session can take the new settings through UpdateSession
+    bool CanUpdateSessionInPlace(
+        const FNamedOnlineSession& ExistingSession, const FOnlineSessionSettings& NewSessionSettings) const;
+    // Creates the session on the session interface, as part of the create operation in flight
+    void CreateSessionWithLastSettings(FName SessionName);
+    // Destroys the existing session, the create operation in flight continues once the destroy completed
+    void RecreateSessionAfterDestroy(FName SessionName);
     TSharedPtr<FOnlineSessionSearch> LastSessionSearch;
+    TSharedPtr<const FSessionSearchSummary> LastSessionSearchSummary;
+    TSharedPtr<const FSessionSearchIndex> LastSessionSearchIndex;
+    // The results last broadcast and their summary, either a batch of the pending search or the last search
+    TSharedPtr<const FOnlineSessionSearch> BroadcastSessionSearch;
+    TSharedPtr<const FSessionSearchSummary> BroadcastSearchSummary;
+
+    //
+    // Join failover
+    // The candidates are kept in the FMultiplayerSessionState of the session being joined
+    //
+
+    // Joins the given results of the search in order, up to MaxJoinAttempts of them. False if there are none
+    bool JoinRankedSearchResults(const FOnlineSessionSearch& Search, const TArray<int32>& RankedResults, FName SessionName);
+    // Starts joining the next candidate, broadcasts LastResult if none is left
+    void JoinNextCandidate(FName SessionName, EOnJoinSessionCompleteResult::Type LastResult);
+    bool OnJoinAttemptTimeout(float DeltaTime, FName SessionName);
+    // Once an abandoned join is over, leaves the session it left behind and goes on with the next candidate
+    void JoinNextCandidateAfterAbandonedJoin(FName SessionName);
+
+    // Most sessions JoinBestSession tries before giving up
+    UPROPERTY(Config)
+    int32 MaxJoinAttempts{3};
+
+    // Seconds a join attempt may take before it is abandoned. The next candidate is tried once the abandoned join
+    // completed, or after as long again if it never does
+    UPROPERTY(Config)
+    float JoinAttemptTimeout{10.f};
+
+    //
+    // Session search cache
+    // Results are kept per query. Entries younger than SessionSearchCacheTTL are served as they are, entries up to
+    // SessionSearchCacheMaxStaleAge are served and refreshed in the background, older ones are searched again.
+    //
+
+    FSessionSearchCacheKey MakeSearchCacheKey(
+        int32 MaxSearchResults, const FString& MatchType, const TMap<FName, FString>& ExtraQuerySettings) const;
+    // Starts a search on the session interface. A background search only refreshes the cache and doesn't broadcast
+    bool StartSessionSearch(const FSessionSearchCacheKey& Key, bool bBackground);
+
+    TMap<FSessionSearchCacheKey, FCachedSessionSearch> SessionSearchCache;
+    // Drops the entries too old to be served, then the oldest ones beyond MaxCachedSearches
+    void TrimSessionSearchCache();
+
+    // The search currently running on the session interface, if any
+    TSharedPtr<FOnlineSessionSearch> PendingSessionSearch;
+    // Summary of the pending search, appended to as its results come in
+    TSharedPtr<FSessionSearchSummary> PendingSearchSummary;
+    FSessionSearchCacheKey PendingSearchKey;
+    bool bPendingSearchIsBackground{false};
+    // The pending search was cancelled. It stays the Find in flight until the backend confirmed, so its late completion
+    // isn't taken for the completion of the next search
+    bool bPendingSearchCancelled{false};
+    // A search requested while another query was running, started when it completes
+    TOptional<FSessionSearchCacheKey> QueuedSearchKey;
+    // Starts the search queued behind the one that just ended, if any
+    void StartQueuedSearch();
+    // Drops the cancelled search, once it can't complete anymore
+    void EndCancelledSearch();
+
+    // Backends add the results to the search while it runs, we poll them to broadcast the new ones in batches
+    bool PollSessionSearch(float DeltaTime);
+    void BroadcastNewSearchResults(
+        const TSharedPtr<FOnlineSessionSearch>& Search, const TSharedPtr<FSessionSearchSummary>& Summary);
+
+    FTSTicker::FDelegateHandle SessionSearchPollHandle;
+    // Number of results of the pending search already broadcast in batches
+    int32 NumBroadcastSearchResults{0};
+
+    // Seconds between two polls of the pending search for new results
+    UPROPERTY(Config)
+    float SessionSearchPollInterval{0.1f};
+
+    // Seconds a cached search result is considered fresh
+    UPROPERTY(Config)
+    float SessionSearchCacheTTL{10.f};
+
+    // Seconds after which a cached search result is no longer served, not even while refreshing it
+    UPROPERTY(Config)
+    float SessionSearchCacheMaxStaleAge{60.f};
+
+    // Most queries kept in the cache, the least recently searched go first
+    UPROPERTY(Config)
+    int32 MaxCachedSearches{8};
+
+    //
+    // Session prefetch
+    // Background searches of one query, so the results are already cached when the player asks for them
+    //
+
+    bool PrefetchSessions(float DeltaTime);
+
+    TOptional<FSessionSearchCacheKey> PrefetchSearchKey;
+    float CurrentPrefetchInterval{0.f};
+    FTSTicker::FDelegateHandle SessionPrefetchHandle;
+
+    UPROPERTY(Config)
+    bool bEnableSessionPrefetch{false};
+
+    // Seconds before the first refresh of the prefetched query
+    UPROPERTY(Config)
+    float SessionPrefetchInterval{8.f};
+
+    // Factor the refresh interval grows by after every prefetch search
+    UPROPERTY(Config)
+    float SessionPrefetchBackoff{2.f};
+
+    // Longest refresh interval. Keep it below SessionSearchCacheMaxStaleAge, so there are always results to serve
+    UPROPERTY(Config)
+    float SessionPrefetchMaxInterval{45.f};
+
+    //
+    // Map preloading
+    //
+
+    void OnMapPreloaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+    void ReleasePreloadedMap();
+    void OnPostLoadMapWithWorld(UWorld* LoadedWorld);
+
+    // Package of the map being preloaded or preloaded, empty if none
+    FString PreloadingMapPackage;
+    double PreloadStartTime{0.0};
+    FDelegateHandle PostLoadMapHandle;
+
+    // Keeps the preloaded map from being garbage collected before we travel to it
+    UPROPERTY(Transient)
+    TObjectPtr<UWorld> PreloadedMap;
+
+    // Whether creating and joining a session preload the map of the session
+    UPROPERTY(Config)
+    bool bPreloadSessionMaps{true};
 
     //
     // To add to the Online Session Interface delegate list
@@ -90,12 +537,20 @@ private:
     // For each of the delegates we need a delegate handle to add and remove them
     //
 
+    bool bSessionInterfaceDelegatesBound{false};
+
     FOnCreateSessionCompleteDelegate CreateSessionCompleteDelegate;
     FDelegateHandle CreateSessionCompleteDelegateHandle;
 
+    FOnUpdateSessionCompleteDelegate UpdateSessionCompleteDelegate;
+    FDelegateHandle UpdateSessionCompleteDelegateHandle;
+
     FOnFindSessionsCompleteDelegate FindSessionsCompleteDelegate;
     FDelegateHandle FindSessionsCompleteDelegateHandle;
 
+    FOnCancelFindSessionsCompleteDelegate CancelFindSessionsCompleteDelegate;
+    FDelegateHandle CancelFindSessionsCompleteDelegateHandle;
+
     FOnJoinSessionCompleteDelegate JoinSessionCompleteDelegate;
     FDelegateHandle JoinSessionCompleteDelegateHandle;
 
@@ -105,9 +560,13 @@ private:
     FOnStartSessionCompleteDelegate StartSessionCompleteDelegate;
     FDelegateHandle StartSessionCompleteDelegateHandle;
 
-    // Variables to store the last session settings used to create a session
-    // so that we can use them to know if we need to create a session on destroy
-    bool bCreateSessionOnDestroy{false};
-    int32 LastNumPublicConnections{0};
-    FString LastMatchType{TEXT("")};
+    // Ranks the search results, created from SessionRankerClass on first use
+    UPROPERTY(Transient)
+    TObjectPtr<USessionRanker> SessionRanker;
+
+    UPROPERTY(Config)
+    TSubclassOf<USessionRanker> SessionRankerClass;
+
+    // The result of the last RankSearchResults call
+    TArray<int32> RankedSearchResults;
 };
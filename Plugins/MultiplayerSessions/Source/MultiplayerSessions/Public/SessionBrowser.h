@@ -0,0 +1,167 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "Blueprint/UserWidget.h"
+#include "CoreMinimal.h"
+#include "Interfaces/OnlineSessionInterface.h"
+
+#include "SessionBrowser.generated.h"
+
+class FSessionSearchSummary;
+class UButton;
+class UListView;
+class UMultiplayerSessionsSubsystem;
+class USessionBrowserEntry;
+enum class ESessionBrowserEntryChange : uint8;
+
+/** The column the session browser is sorted by */
+UENUM(BlueprintType)
+enum class ESessionBrowserSortKey : uint8
+{
+    Ping,
+    /** How full the session is */
+    Occupancy,
+    MatchType,
+    OwnerName
+};
+
+/**
+ * USessionBrowser is a server browser widget listing the sessions found by the MultiplayerSessionsSubsystem.
+ *
+ * The list is a UListView, which only creates row widgets (USessionBrowserEntryWidget) for the rows on screen, so it
+ * scales to thousands of sessions. Every session has one USessionBrowserEntry, keyed by its session id, that is updated
+ * in place by the next searches instead of being recreated. The new and moved sessions of every batch are inserted into
+ * the sorted and filtered list, only changing the sort or the filter sorts the whole list again.
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API USessionBrowser : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    /** Searches for sessions again, the list is updated as the results come in. */
+    UFUNCTION(BlueprintCallable, Category = "Session Browser")
+    void RefreshSessions();
+
+    /** Joins the selected session, travelling to it once joined. */
+    UFUNCTION(BlueprintCallable, Category = "Session Browser")
+    void JoinSelectedSession();
+
+    UFUNCTION(BlueprintCallable, Category = "Session Browser")
+    void SetSortKey(ESessionBrowserSortKey NewSortKey, bool bNewSortDescending = false);
+
+    /** Only lists the sessions with this match type, an empty one lists every match type. */
+    UFUNCTION(BlueprintCallable, Category = "Session Browser")
+    void SetMatchTypeFilter(const FString& NewMatchTypeFilter);
+
+    /** Only lists the sessions with at most this ping, 0 lists every session. */
+    UFUNCTION(BlueprintCallable, Category = "Session Browser")
+    void SetMaxPingFilter(int32 NewMaxPingMs);
+
+    UFUNCTION(BlueprintCallable, Category = "Session Browser")
+    void SetOccupancyFilter(bool bNewHideFullSessions, bool bNewHideEmptySessions);
+
+    /** Number of sessions found, listed or not */
+    UFUNCTION(BlueprintPure, Category = "Session Browser")
+    int32 GetNumSessions() const { return EntriesBySessionId.Num(); }
+
+    /** Number of sessions that pass the filters */
+    UFUNCTION(BlueprintPure, Category = "Session Browser")
+    int32 GetNumListedSessions() const { return ListedEntries.Num(); }
+
+protected:
+    virtual bool Initialize() override;
+    virtual void NativeConstruct() override;
+    virtual void NativeDestruct() override;
+
+    /** Size of the query sent to the backend */
+    UPROPERTY(EditAnywhere, Category = "Session Browser")
+    int32 MaxSearchResults{10000};
+
+    UPROPERTY(EditAnywhere, Category = "Session Browser")
+    ESessionBrowserSortKey SortKey{ESessionBrowserSortKey::Ping};
+
+    UPROPERTY(EditAnywhere, Category = "Session Browser")
+    bool bSortDescending = false;
+
+    UPROPERTY(EditAnywhere, Category = "Session Browser|Filter")
+    FString MatchTypeFilter;
+
+    UPROPERTY(EditAnywhere, Category = "Session Browser|Filter")
+    int32 MaxPingMs{0};
+
+    UPROPERTY(EditAnywhere, Category = "Session Browser|Filter")
+    bool bHideFullSessions = true;
+
+    UPROPERTY(EditAnywhere, Category = "Session Browser|Filter")
+    bool bHideEmptySessions = false;
+
+private:
+    // not UFUNCTION() because the delegates are not dynamic
+    void OnFindSessionsBatch(const TArray<FOnlineSessionSearchResult>& SearchResults, int32 FirstNewResult);
+    void OnFindSessions(const TArray<FOnlineSessionSearchResult>& SearchResults, bool bWasSuccessful);
+    void OnJoinSession(EOnJoinSessionCompleteResult::Type Result);
+    void OnSessionDoubleClicked(UObject* Item);
+
+    /**
+     * Merges the rows of the summary from FirstRow on into the entries and the listed entries.
+     * @return true if the listed entries changed
+     */
+    bool MergeSummaryRows(const FSessionSearchSummary& Summary, int32 FirstRow);
+    /**
+     * Drops the entries of the sessions that were not in the search of the current generation.
+     * @return true if the listed entries changed
+     */
+    bool RemoveUnseenEntries();
+    /** Filters and sorts every entry again, for when the filter or the sort changed. */
+    void RebuildListedEntries();
+
+    bool PassesFilter(const USessionBrowserEntry& Entry) const;
+    /** Whether A is listed before B */
+    bool IsListedBefore(const USessionBrowserEntry& A, const USessionBrowserEntry& B) const;
+    /** Whether a change of these fields can move the entry in the list */
+    bool AffectsListPosition(ESessionBrowserEntryChange Changes) const;
+
+    // These widgets are binded in the blueprint and the names must match the names in the blueprint
+
+    /** The list of sessions, its Entry Widget Class should be a USessionBrowserEntryWidget */
+    UPROPERTY(meta = (BindWidget))
+    UListView* SessionList;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    UButton* RefreshButton;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    UButton* JoinButton;
+
+    // Functions bound to the buttons must be UFUNCTION()
+
+    UFUNCTION()
+    void RefreshButtonClicked();
+
+    UFUNCTION()
+    void JoinButtonClicked();
+
+    UPROPERTY()
+    UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem;
+
+    /** Every session found, by its session id */
+    UPROPERTY(Transient)
+    TMap<FString, TObjectPtr<USessionBrowserEntry>> EntriesBySessionId;
+
+    /** The entries passing the filter, in list order. This is what the UListView shows */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<USessionBrowserEntry>> ListedEntries;
+
+    /** Entries of sessions that went away, reused for new ones instead of creating objects for every search */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<USessionBrowserEntry>> FreeEntries;
+
+    // Hash of MatchTypeFilter, see FSessionSearchSummary::HashMatchType
+    uint32 MatchTypeFilterHash{0};
+    // Bumped with every search, to tell the sessions that are still around from the ones that went away
+    uint32 Generation{0};
+    // Whether the join in flight was started by this browser, it travels when it succeeds
+    bool bJoinRequested = false;
+};
@@ -0,0 +1,68 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+
+#include "SessionBrowserEntry.generated.h"
+
+class FSessionSearchSummary;
+
+/** The fields of a USessionBrowserEntry that changed in an update */
+enum class ESessionBrowserEntryChange : uint8
+{
+    None = 0,
+    Ping = 1 << 0,
+    Players = 1 << 1,
+    MatchType = 1 << 2,
+    OwnerName = 1 << 3,
+};
+ENUM_CLASS_FLAGS(ESessionBrowserEntryChange);
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSessionBrowserEntryChanged, ESessionBrowserEntryChange Changes);
+
+/**
+ * USessionBrowserEntry is the list item of a session in the USessionBrowser, the UListView only creates row widgets
+ * for the entries that are on screen.
+ * The entry of a session is kept across searches and updated in place, so its row widget only redraws what changed.
+ */
+UCLASS(BlueprintType)
+class MULTIPLAYERSESSIONS_API USessionBrowserEntry : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * Copies a row of the search summary into the entry.
+     * @return The fields that changed, nothing is broadcast, the browser decides whether the row moved
+     */
+    ESessionBrowserEntryChange UpdateFrom(const FSessionSearchSummary& Summary, int32 Row);
+
+    /** Broadcast by the browser when the entry was updated in place, the row widget showing it refreshes then */
+    FOnSessionBrowserEntryChanged OnChanged;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Session")
+    FString OwnerName;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Session")
+    FString MatchType;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Session")
+    int32 PingMs{0};
+
+    UPROPERTY(BlueprintReadOnly, Category = "Session")
+    int32 NumPlayers{0};
+
+    UPROPERTY(BlueprintReadOnly, Category = "Session")
+    int32 MaxPlayers{0};
+
+    FString SessionId;
+    uint32 MatchTypeHash{0};
+    // Index of the session in the search results it was last seen in
+    int32 ResultIndex{INDEX_NONE};
+    // The browser search it was last seen in, entries not seen by the end of a search are dropped
+    uint32 SeenGeneration{0};
+    // Whether it is in the filtered list the UListView shows
+    bool bIsListed = false;
+};
@@ -0,0 +1,52 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "Blueprint/IUserObjectListEntry.h"
+#include "Blueprint/UserWidget.h"
+#include "CoreMinimal.h"
+
+#include "SessionBrowserEntryWidget.generated.h"
+
+class USessionBrowserEntry;
+class UTextBlock;
+enum class ESessionBrowserEntryChange : uint8;
+
+/**
+ * USessionBrowserEntryWidget is the row widget of the session browser, set it as the Entry Widget Class of its list.
+ * The list recycles the row widgets while scrolling, so a row only exists for the sessions on screen.
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API USessionBrowserEntryWidget : public UUserWidget, public IUserObjectListEntry
+{
+    GENERATED_BODY()
+
+protected:
+    virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+    virtual void NativeOnEntryReleased() override;
+
+private:
+    void OnEntryChanged(ESessionBrowserEntryChange Changes);
+    void Refresh(ESessionBrowserEntryChange Changes);
+    void StopWatchingEntry();
+
+    // These texts are binded in the blueprint and the names must match the names in the blueprint
+
+    UPROPERTY(meta = (BindWidget))
+    UTextBlock* OwnerNameText;
+
+    UPROPERTY(meta = (BindWidget))
+    UTextBlock* MatchTypeText;
+
+    UPROPERTY(meta = (BindWidget))
+    UTextBlock* PlayersText;
+
+    UPROPERTY(meta = (BindWidget))
+    UTextBlock* PingText;
+
+    /** The session the row currently shows, rows are reused for other sessions while scrolling */
+    UPROPERTY(Transient)
+    TObjectPtr<USessionBrowserEntry> Entry;
+
+    FDelegateHandle EntryChangedHandle;
+};
@@ -0,0 +1,59 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "Containers/StaticArray.h"
+#include "CoreMinimal.h"
+
+enum class ESessionOperation : uint8;
+
+/**
+ * FSessionLatencyTracker measures how long each session operation takes, from the request to the completion delegate.
+ *
+ * Every completed operation is sent as an Unreal Insights event on the MultiplayerSessions trace channel and as a CSV
+ * profiler stat, and kept in a rolling window per operation to report percentiles with the
+ * MultiplayerSessions.DumpLatency console command.
+ */
+class MULTIPLAYERSESSIONS_API FSessionLatencyTracker
+{
+public:
+    /** Number of samples kept per operation to compute the percentiles */
+    static constexpr int32 WindowSize = 256;
+
+    /** Starts timing an operation. */
+    void Begin(ESessionOperation Operation);
+
+    /**
+     * Stops timing an operation and records how long it took. Does nothing if the operation wasn't started.
+     * @return the latency in milliseconds, 0 if the operation wasn't started
+     */
+    float End(ESessionOperation Operation, bool bWasSuccessful);
+
+    /**
+     * Records an operation timed by the caller, for operations that can be in flight several times at once, e.g. on
+     * different named sessions.
+     * @return the latency in milliseconds
+     */
+    float Record(ESessionOperation Operation, uint64 StartCycles, bool bWasSuccessful);
+
+    /** Writes the p50, p95 and p99 latency of every operation to the output device. */
+    void Dump(FOutputDevice& Ar) const;
+
+    static const TCHAR* GetOperationName(ESessionOperation Operation);
+
+private:
+    struct FOperationSamples
+    {
+        // Cycles64 when the operation in flight started, 0 if none is
+        uint64 StartCycles{0};
+
+        // Ring of the latest latencies in milliseconds
+        TStaticArray<float, WindowSize> LatenciesMs{InPlace, 0.f};
+        int32 NextSample{0};
+        int32 NumSamples{0};
+        int32 NumFailures{0};
+    };
+
+    static constexpr int32 NumOperations = 7;
+    TStaticArray<FOperationSamples, NumOperations> Operations;
+};
@@ -0,0 +1,85 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+
+#include "SessionRanker.generated.h"
+
+class FSessionSearchSummary;
+
+/**
+ * USessionRanker scores the sessions found by a search and orders them from the best to the worst one to join.
+ *
+ * The default scoring prefers sessions with a low ping, that keep a few slots open so the join doesn't race with other
+ * players for the last one, and that are already well populated. The weights are read from the Game config.
+ * Subclass it and set SessionRankerClass on the MultiplayerSessionsSubsystem to change how sessions are scored.
+ */
+UCLASS(Config = Game)
+class MULTIPLAYERSESSIONS_API USessionRanker : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * Orders the candidates from the best to the worst session. Sessions that can't be joined are left out.
+     * Candidates with the same score keep the order they have in the search results.
+     * @param Summary The summary of the search results
+     * @param Candidates Indices into the search results of the sessions to rank
+     * @param OutRanked Indices into the search results of the viable sessions, the best one first
+     */
+    void RankSessions(const FSessionSearchSummary& Summary, const TArray<int32>& Candidates, TArray<int32>& OutRanked) const;
+
+    /**
+     * Picks the best of the candidates if it is good enough to be joined without waiting for the rest of the search.
+     * @param Summary The summary of the results received so far
+     * @param Candidates Indices into the search results of the sessions to look at
+     * @return The index into the search results of that session, INDEX_NONE if no viable candidate scores GoodEnoughScore
+     */
+    int32 PickGoodEnoughSession(const FSessionSearchSummary& Summary, const TArray<int32>& Candidates) const;
+
+protected:
+    /**
+     * Whether the session can be joined at all.
+     * Called from worker threads when there are many candidates, so it must not touch any UObject state.
+     */
+    virtual bool IsViable(const FSessionSearchSummary& Summary, int32 Row) const;
+
+    /**
+     * Scores a viable session, higher is better.
+     * Called from worker threads when there are many candidates, so it must not touch any UObject state.
+     */
+    virtual float ScoreSession(const FSessionSearchSummary& Summary, int32 Row) const;
+
+    /** Weight of the ping score, which goes from 1 at no ping to 0 at MaxPingMs */
+    UPROPERTY(Config, EditAnywhere, Category = "Scoring")
+    float PingWeight{1.f};
+
+    /** Weight of the open slots score, which goes from 0 with no open slot to 1 with DesiredOpenSlots or more */
+    UPROPERTY(Config, EditAnywhere, Category = "Scoring")
+    float OpenSlotsWeight{0.5f};
+
+    /** Weight of the fill rate score, which goes from 0 for an empty session to 1 for a full one */
+    UPROPERTY(Config, EditAnywhere, Category = "Scoring")
+    float FillRateWeight{0.25f};
+
+    /** Sessions with a known ping above this are not joined */
+    UPROPERTY(Config, EditAnywhere, Category = "Scoring")
+    int32 MaxPingMs{250};
+
+    /** Number of open slots above which a session doesn't score any better */
+    UPROPERTY(Config, EditAnywhere, Category = "Scoring")
+    int32 DesiredOpenSlots{4};
+
+    /**
+     * Score from which a session is joined as soon as the search streams it in. The default weights score at most 1.75,
+     * so 1.25 asks for a low ping with a few open slots. Set it above the maximum score to always wait for the full search.
+     */
+    UPROPERTY(Config, EditAnywhere, Category = "Scoring")
+    float GoodEnoughScore{1.25f};
+
+    /** Number of candidates from which they are scored in parallel */
+    UPROPERTY(Config, EditAnywhere, Category = "Performance")
+    int32 ParallelScoringThreshold{512};
+};
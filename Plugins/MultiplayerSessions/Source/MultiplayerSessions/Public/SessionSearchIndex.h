@@ -0,0 +1,32 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SessionSearchSummary.h"
+
+/** Session setting the host advertises its match type with, and the key the search filters on */
+#define SETTING_MATCHTYPE FName(TEXT("MatchType"))
+
+/**
+ * FSessionSearchIndex maps the match type of every session in a search to its position in the search results.
+ * It is built once from the summary when a search completes, so finding the sessions of a match type doesn't need to scan
+ * the results again.
+ */
+class MULTIPLAYERSESSIONS_API FSessionSearchIndex
+{
+public:
+    /** Indexes the summarized search results, replacing the previous content. */
+    void Build(const FSessionSearchSummary& Summary);
+
+    /**
+     * Returns the indices into the indexed search results of the sessions with the given match type, in search order.
+     * The returned array is empty if no session has that match type.
+     */
+    const TArray<int32>& Find(const FString& MatchType) const;
+
+private:
+    // Keyed by the match type itself, like FString comparison it is case-insensitive. Match types whose hashes collide
+    // still get a key each
+    TMap<FString, TArray<int32>> ByMatchType;
+};
@@ -0,0 +1,76 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FOnlineSessionSearchResult;
+
+/**
+ * FSessionSearchSummary is a compact view of search results, built once per search so the UI, the filtering and the
+ * ranking don't dig the same fields out of every FOnlineSessionSearchResult and its settings again.
+ *
+ * Row i summarizes SearchResults[i]. The fields are stored column by column, so going over one field of thousands of
+ * sessions reads contiguous memory, and the strings are pooled in one arena instead of being allocated one by one.
+ */
+class MULTIPLAYERSESSIONS_API FSessionSearchSummary
+{
+public:
+    /**
+     * Summarizes the search results that are not summarized yet, i.e. from Num() on.
+     * A search that is still running can be summarized batch by batch as its results come in.
+     */
+    void Append(const TArray<FOnlineSessionSearchResult>& SearchResults);
+    void Reset();
+
+    int32 Num() const { return PingsMs.Num(); }
+
+    /** Whether the result has a host and session info, i.e. it can be joined at all. */
+    bool IsValid(int32 Row) const { return ValidRows[Row]; }
+    /** Hash of the session id, to tell sessions apart across searches without comparing the ids. 0 without session info */
+    uint32 GetSessionIdHash(int32 Row) const { return SessionIdHashes[Row]; }
+    int32 GetPingMs(int32 Row) const { return PingsMs[Row]; }
+    int32 GetOpenSlots(int32 Row) const { return OpenSlots[Row]; }
+    int32 GetMaxSlots(int32 Row) const { return MaxSlots[Row]; }
+    /** HashMatchType of the match type. Rows without a match type have an empty one */
+    uint32 GetMatchTypeHash(int32 Row) const { return MatchTypeHashes[Row]; }
+
+    // The views point into the arena, they are valid until the summary is appended to or reset
+    FStringView GetSessionId(int32 Row) const { return GetString(SessionIds[Row]); }
+    FStringView GetOwnerName(int32 Row) const { return GetString(OwnerNames[Row]); }
+    FStringView GetMatchType(int32 Row) const { return GetString(MatchTypes[Row]); }
+
+    /** Whether the row has the given match type, comparing the hashes first. Like FString comparison, it is case-insensitive */
+    bool HasMatchType(int32 Row, FStringView MatchType, uint32 MatchTypeHash) const
+    {
+        return MatchTypeHashes[Row] == MatchTypeHash && GetMatchType(Row).Equals(MatchType, ESearchCase::IgnoreCase);
+    }
+
+    /** Hash used for match types, the CRC of the lowercased match type. Like FString comparison, it is case-insensitive. */
+    static uint32 HashMatchType(FStringView MatchType);
+
+private:
+    struct FArenaString
+    {
+        int32 Offset{0};
+        int32 Len{0};
+    };
+
+    FArenaString AddString(FStringView String);
+    FStringView GetString(const FArenaString& String) const
+    {
+        return FStringView(StringArena.GetData() + String.Offset, String.Len);
+    }
+
+    TBitArray<> ValidRows;
+    TArray<uint32> SessionIdHashes;
+    TArray<int32> PingsMs;
+    TArray<int32> OpenSlots;
+    TArray<int32> MaxSlots;
+    TArray<uint32> MatchTypeHashes;
+
+    TArray<FArenaString> SessionIds;
+    TArray<FArenaString> OwnerNames;
+    TArray<FArenaString> MatchTypes;
+    TArray<TCHAR> StringArena;
+};
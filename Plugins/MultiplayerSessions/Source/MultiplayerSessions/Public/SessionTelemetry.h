@@ -0,0 +1,89 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+enum class ESessionOperation : uint8;
+
+// Set by MultiplayerSessions.Build.cs, for the builds that don't go through it
+#ifndef WITH_SESSION_TELEMETRY
+#define WITH_SESSION_TELEMETRY 1
+#endif
+
+/** A completed session operation, as recorded by FSessionTelemetry. Plain data, nothing is formatted when recording */
+struct FSessionTelemetryEvent
+{
+    /** FPlatformTime::Seconds() when the operation completed */
+    double Time{0.0};
+    /** None for the searches, they are not on a named session */
+    FName SessionName;
+    float DurationMs{0.f};
+    /** Number of search results for Find, 0 for the other operations */
+    int32 NumResults{0};
+    ESessionOperation Operation{};
+    /** EOnJoinSessionCompleteResult for Join, 0 for the other operations */
+    uint8 ResultCode{0};
+    bool bWasSuccessful{false};
+};
+
+#if WITH_SESSION_TELEMETRY
+
+/**
+ * FSessionTelemetry keeps the last session operations in a fixed size ring, so the join failures of a shipped game can
+ * be diagnosed from a file instead of from log lines and on-screen messages.
+ *
+ * Recording takes no lock and doesn't allocate or format anything, any thread may record. Flush appends the events
+ * recorded since the last flush to Saved/Logs/SessionTelemetry.csv, it is called periodically by the sessions
+ * subsystem and by the MultiplayerSessions.FlushTelemetry console command. When more than Capacity events are recorded
+ * between two flushes, the oldest ones are overwritten and counted as dropped.
+ *
+ * Compiled out when WITH_SESSION_TELEMETRY is 0, see MultiplayerSessions.Build.cs.
+ */
+class MULTIPLAYERSESSIONS_API FSessionTelemetry
+{
+public:
+    /** Number of events kept between two flushes, a power of two */
+    static constexpr uint64 Capacity = 1024;
+
+    static FSessionTelemetry& Get();
+
+    void Record(const FSessionTelemetryEvent& Event);
+
+    /**
+     * Writes the events recorded since the last flush to the file.
+     * @return the number of events written
+     */
+    int32 Flush();
+
+    FString GetFilePath() const;
+
+    /** Events overwritten before they were flushed, since start */
+    uint64 GetNumDropped() const { return NumDropped; }
+
+private:
+    static_assert((Capacity & (Capacity - 1)) == 0, "The ring is indexed with a mask");
+
+    struct FSlot
+    {
+        // 2 * (Index + 1) once the event of that index is written, odd while it is being written
+        std::atomic<uint64> Sequence{0};
+        FSessionTelemetryEvent Event;
+    };
+
+    FSlot Slots[Capacity];
+    // Index of the next event to record, reserved by the recording threads
+    std::atomic<uint64> NextWrite{0};
+
+    // Only read and written by Flush, under FlushLock
+    FCriticalSection FlushLock;
+    uint64 NextRead{0};
+    bool bFileHasHeader = false;
+
+    std::atomic<uint64> NumDropped{0};
+};
+
+#endif    // WITH_SESSION_TELEMETRY
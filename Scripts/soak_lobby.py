@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+# Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+"""Headless soak test of the session flow on localhost.
+
+Launches one listen server host and N clients, all with -nullrhi -nosound on the NULL online subsystem, so the
+game net driver falls back from the Steam net driver to the IpNetDriver. USoakTestSubsystem drives each process:
+the host creates a session and travels to the lobby, every client runs Find -> Join -> ClientTravel.
+When they are done the logs are parsed and the script prints the join time distributions of the clients together
+with the frame time and bandwidth of the host.
+With --churn, every client leaves after a few seconds and a new one takes its place, to measure the hitches of players
+dropping in and out of the lobby, e.g. with and without --no-pawn-pool.
+With --stagger 0 every client joins at once, compare the host frame time with and without --no-admission-control.
+
+Example, from the project root:
+    python Scripts/soak_lobby.py --binary "C:/UE_5.4/Engine/Binaries/Win64/UnrealEditor.exe" --clients 16
+or against a packaged game:
+    python Scripts/soak_lobby.py --binary Packaged/Linux/MenuSystem.sh --packaged --clients 16
+"""
+
+import argparse
+import json
+import math
+import re
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+PROJECT_FILE = Path(__file__).resolve().parent.parent / "MenuSystem.uproject"
+
+COMMON_ARGS = [
+    "-nullrhi",
+    "-nosound",
+    "-unattended",
+    "-nosplash",
+    "-log",
+    # No Steam: the NULL subsystem advertises sessions over LAN and the net driver falls back to the IpNetDriver
+    "-ini:Engine:[OnlineSubsystem]:DefaultPlatformService=Null",
+    "-ini:Engine:[OnlineSubsystemSteam]:bEnabled=False",
+    # The host stays in the lobby, a full lobby would otherwise travel everyone to the match
+    "-ini:Game:[/Script/MenuSystem.LobbyGameMode]:bAutoStartMatch=False",
+]
+
+RESULT_PATTERN = re.compile(r"SoakResult: (.*)$")
+HOST_STATS_PATTERN = re.compile(r"SoakHost: Time=.*$")
+FIELD_PATTERN = re.compile(r"(\w+)=(\S+)")
+
+
+def parse_fields(line):
+    """Turns the Key=Value pairs of a soak log line into a dict, numbers are converted."""
+    fields = {}
+    for key, value in FIELD_PATTERN.findall(line):
+        try:
+            fields[key] = float(value)
+        except ValueError:
+            fields[key] = value
+    return fields
+
+
+def percentile(sorted_values, fraction):
+    if not sorted_values:
+        return float("nan")
+    index = min(len(sorted_values) - 1, max(0, math.ceil(fraction * len(sorted_values)) - 1))
+    return sorted_values[index]
+
+
+def distribution(values):
+    values = sorted(values)
+    if not values:
+        return {}
+    return {
+        "count": len(values),
+        "min": values[0],
+        "p50": percentile(values, 0.50),
+        "p95": percentile(values, 0.95),
+        "p99": percentile(values, 0.99),
+        "max": values[-1],
+        "mean": sum(values) / len(values),
+    }
+
+
+def launch(args, name, role_args):
+    log_path = args.log_dir / f"{name}.log"
+    command = [str(args.binary)]
+    if not args.packaged:
+        command += [str(args.project), "-game"]
+    command += COMMON_ARGS + role_args + [f"-abslog={log_path}", f"-SoakMatchType={args.match_type}"]
+    command += args.extra_args
+    print(f"Launching {name}: {' '.join(command)}")
+    return subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL), log_path
+
+
+def read_lines(log_path, pattern):
+    if not log_path.exists():
+        return []
+    with open(log_path, encoding="utf-8", errors="replace") as log:
+        return [match.group(0) for match in map(pattern.search, log) if match]
+
+
+def summarize(host_log, client_logs):
+    results = []
+    for log_path in client_logs:
+        lines = read_lines(log_path, RESULT_PATTERN)
+        results.append(parse_fields(lines[-1]) if lines else {"Outcome": "NoResult"})
+
+    outcomes = {}
+    for result in results:
+        outcomes[result["Outcome"]] = outcomes.get(result["Outcome"], 0) + 1
+    joined = [result for result in results if result["Outcome"] == "Joined"]
+
+    # Skip the samples before the first client connected, they only show an idle lobby
+    host_stats = [parse_fields(line) for line in read_lines(host_log, HOST_STATS_PATTERN)]
+    loaded_stats = [stats for stats in host_stats if stats.get("Clients", 0) > 0]
+
+    return {
+        "clients": len(client_logs),
+        "outcomes": outcomes,
+        "join": {key: distribution([result[key] for result in joined]) for key in
+                 ("FindMs", "JoinMs", "TravelMs", "TotalMs", "FindAttempts")},
+        "host": {
+            "peak_clients": max((stats.get("Clients", 0) for stats in host_stats), default=0),
+            "avg_frame_ms": distribution([stats["AvgFrameMs"] for stats in loaded_stats]),
+            "max_frame_ms": distribution([stats["MaxFrameMs"] for stats in loaded_stats]),
+            "in_bytes_per_sec": distribution([stats["InBytesPerSec"] for stats in loaded_stats]),
+            "out_bytes_per_sec": distribution([stats["OutBytesPerSec"] for stats in loaded_stats]),
+            # Running totals, the last sample has them all
+            "pawn_pool_hits": host_stats[-1].get("PoolHits", 0) if host_stats else 0,
+            "pawn_pool_misses": host_stats[-1].get("PoolMisses", 0) if host_stats else 0,
+            "peak_queued": max((stats.get("Queued", 0) for stats in host_stats), default=0),
+        },
+    }
+
+
+def print_summary(summary):
+    def row(name, dist, unit=""):
+        if not dist:
+            print(f"  {name:<20} no samples")
+            return
+        print(f"  {name:<20} p50 {dist['p50']:>10.1f}{unit}  p95 {dist['p95']:>10.1f}{unit}  "
+              f"p99 {dist['p99']:>10.1f}{unit}  max {dist['max']:>10.1f}{unit}  (n={dist['count']})")
+
+    print(f"\nClients: {summary['clients']}  outcomes: {summary['outcomes']}")
+    print("Join times")
+    for key, dist in summary["join"].items():
+        row(key, dist)
+    host = summary["host"]
+    print(f"Host (peak {host['peak_clients']:.0f} clients, samples with at least one client)")
+    row("AvgFrameMs", host["avg_frame_ms"])
+    row("MaxFrameMs", host["max_frame_ms"])
+    row("InBytesPerSec", host["in_bytes_per_sec"])
+    row("OutBytesPerSec", host["out_bytes_per_sec"])
+    print(f"  Pawn pool            hits {host['pawn_pool_hits']:.0f}  misses {host['pawn_pool_misses']:.0f}")
+    print(f"  Admission queue      peak {host['peak_queued']:.0f}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--binary", type=Path, required=True, help="UnrealEditor(-Cmd) or the packaged game")
+    parser.add_argument("--packaged", action="store_true", help="--binary is a packaged game, not the editor")
+    parser.add_argument("--project", type=Path, default=PROJECT_FILE, help="The .uproject when running the editor")
+    parser.add_argument("--clients", type=int, default=8, help="Number of client processes")
+    parser.add_argument("--duration", type=float, default=120.0, help="Seconds the clients stay in the lobby")
+    parser.add_argument("--churn", type=float, default=0.0,
+                        help="Seconds after which a client exits and a new one replaces it, until --duration is over")
+    parser.add_argument("--host-warmup", type=float, default=10.0, help="Seconds to wait before starting clients")
+    parser.add_argument("--stagger", type=float, default=0.5, help="Seconds between two client launches")
+    parser.add_argument("--join-timeout", type=float, default=120.0, help="Seconds a client has to reach the lobby")
+    parser.add_argument("--match-type", default="FreeForAll")
+    parser.add_argument("--log-dir", type=Path, default=Path("Saved/Soak") / time.strftime("%Y%m%d-%H%M%S"))
+    parser.add_argument("--json", type=Path, help="Also write the summary to this file")
+    parser.add_argument("--no-replication-graph", action="store_true",
+                        help="The host uses the default replication, to compare it with the replication graph")
+    parser.add_argument("--no-pawn-pool", action="store_true",
+                        help="The lobby spawns and destroys the pawns instead of reusing them, to compare the hitches")
+    parser.add_argument("--no-admission-control", action="store_true",
+                        help="The lobby spawns every joining player right away instead of a few per second")
+    parser.add_argument("extra_args", nargs="*", help="Passed to every process, after --")
+    args = parser.parse_args()
+
+    args.log_dir.mkdir(parents=True, exist_ok=True)
+    if args.churn > 0:
+        client_lifetime = args.churn
+        run_time = args.duration + args.churn
+    else:
+        client_lifetime = args.join_timeout + args.duration
+        run_time = client_lifetime
+    join_timeout = min(args.join_timeout, client_lifetime)
+    host_lifetime = args.host_warmup + args.clients * args.stagger + run_time + 10.0
+
+    host_args = ["-SoakHost", f"-SoakMaxPlayers={args.clients + 1}", f"-SoakDuration={host_lifetime:.0f}"]
+    if args.no_replication_graph:
+        host_args.append("-DPCVars=MenuSystem.RepGraph.Enable=0")
+    if args.no_pawn_pool:
+        host_args.append("-ini:Game:[/Script/MenuSystem.LobbyGameMode]:bPoolPawns=False")
+    if args.no_admission_control:
+        host_args.append("-ini:Game:[/Script/MenuSystem.LobbyGameMode]:bAdmissionControl=False")
+    host, host_log = launch(args, "host", host_args)
+    client_args = ["-SoakClient", f"-SoakDuration={client_lifetime:.0f}", f"-SoakJoinTimeout={join_timeout:.0f}"]
+    # Every client process launched, and the index in it of the one currently running in each slot
+    clients = []
+    slots = []
+    try:
+        time.sleep(args.host_warmup)
+        for index in range(args.clients):
+            slots.append(len(clients))
+            clients.append(launch(args, f"client_{index:03d}", client_args))
+            time.sleep(args.stagger)
+
+        # Replace the clients that left, the host sees a steady stream of joins and leaves
+        churn_end = time.monotonic() + args.duration
+        while args.churn > 0 and time.monotonic() < churn_end:
+            for index, client in enumerate(slots):
+                if clients[client][0].poll() is not None:
+                    slots[index] = len(clients)
+                    clients.append(launch(args, f"client_{index:03d}_{len(clients):04d}", client_args))
+            time.sleep(0.5)
+
+        # Processes exit on their own once their soak duration is over, the timeouts are only a safety net
+        for process, _ in clients:
+            try:
+                process.wait(timeout=client_lifetime + 60.0)
+            except subprocess.TimeoutExpired:
+                process.kill()
+        try:
+            host.wait(timeout=60.0)
+        except subprocess.TimeoutExpired:
+            host.kill()
+    finally:
+        for process in [host] + [process for process, _ in clients]:
+            if process.poll() is None:
+                process.kill()
+
+    summary = summarize(host_log, [log_path for _, log_path in clients])
+    print_summary(summary)
+    print(f"\nLogs in {args.log_dir}")
+    if args.json:
+        args.json.write_text(json.dumps(summary, indent=2))
+
+    return 0 if summary["outcomes"].get("Joined", 0) == len(clients) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -3,37 +3,459 @@
 #include "LobbyGameMode.h"
 
 #include "GameFramework/PlayerState.h"
+#include "LobbyGameState.h"
+#include "LobbyPlayerController.h"
+#include "MenuSystem.h"
+#include "MenuSystemCharacter.h"
+#include "MultiplayerSessions.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawn pool hits"), STAT_PawnPoolHits, STATGROUP_MenuSystem);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawn pool misses"), STAT_PawnPoolMisses, STATGROUP_MenuSystem);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled pawns"), STAT_PooledPawns, STATGROUP_MenuSystem);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued players"), STAT_QueuedPlayers, STATGROUP_MenuSystem);
+
+ALobbyGameMode::ALobbyGameMode()
+{
+    GameStateClass = ALobbyGameState::StaticClass();
+    PlayerControllerClass = ALobbyPlayerController::StaticClass();
+
+    // The players are taken to the match without disconnecting, through the transition map. Seamless travel doesn't
+    // run in PIE unless net.AllowPIESeamlessTravel is set, test it with standalone games
+    bUseSeamlessTravel = true;
+}
+
+void ALobbyGameMode::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (IsRunningDedicatedServer())
+    {
+        HostDedicatedSession();
+    }
+    if (bPoolPawns && PawnPoolPrewarm > 0)
+    {
+        GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::PrewarmPawnPool);
+    }
+
+    AdmissionTokens = AdmissionBurst;
+    AdmissionRefillTime = GetWorld()->GetRealTimeSeconds();
+}
+
+void ALobbyGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // The pooled pawns go away with the world
+    DEC_DWORD_STAT_BY(STAT_PooledPawns, PooledPawns.Num());
+    PooledPawns.Reset();
+    // The queued players get their pawn from the game mode of the next map
+    DEC_DWORD_STAT_BY(STAT_QueuedPlayers, AdmissionQueue.Num());
+    AdmissionQueue.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ALobbyGameMode::PreLogin(
+    const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage)
+{
+    // The game session already refuses the players beyond its MaxPlayers
+    Super::PreLogin(Options, Address, UniqueId, ErrorMessage);
+    if (!ErrorMessage.IsEmpty())
+    {
+        return;
+    }
+
+    // Refused now, before a player controller is spawned for them and they load the lobby
+    const UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem =
+        GetGameInstance() ? GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+    const int32 NumPublicConnections =
+        MultiplayerSessionsSubsystem ? MultiplayerSessionsSubsystem->GetNumPublicConnections() : 0;
+    if (bMatchStarting)
+    {
+        ErrorMessage = TEXT("The match is starting");
+    }
+    else if (NumPublicConnections > 0 && GetNumPlayers() >= NumPublicConnections)
+    {
+        ErrorMessage = TEXT("The lobby is full");
+    }
+    else if (bAdmissionControl && MaxQueuedPlayers > 0 && AdmissionQueue.Num() >= MaxQueuedPlayers)
+    {
+        ErrorMessage = TEXT("Too many players are joining the lobby, try again in a moment");
+    }
+
+    if (!ErrorMessage.IsEmpty())
+    {
+        UE_LOG(LogMultiplayerSessions, Log, TEXT("Refused a player from %s: %s"), *Address, *ErrorMessage);
+    }
+}
 
 void ALobbyGameMode::PostLogin(APlayerController* NewPlayer)
 {
     Super::PostLogin(NewPlayer);
 
-    // access the game state
-    if (GameState)
+    ALobbyGameState* LobbyGameState = GetGameState<ALobbyGameState>();
+    if (LobbyGameState == nullptr)
+    {
+        return;
+    }
+    LobbyGameState->AddPlayer(NewPlayer->PlayerState);
+
+    const int32 NumberOfPlayers = LobbyGameState->GetNumRosterPlayers();
+    UE_LOG(LogMultiplayerSessions, Log, TEXT("Players in the lobby: %d"), NumberOfPlayers);
+
+    if (const APlayerState* PlayerState = NewPlayer->GetPlayerState<APlayerState>())
+    {
+        UE_LOG(LogMultiplayerSessions, Verbose, TEXT("%s joined the lobby"), *PlayerState->GetPlayerName());
+    }
+
+    UpdateMatchStart(NumberOfPlayers);
+}
+
+void ALobbyGameMode::HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer)
+{
+    // The host's own player doesn't wait, nor does anyone when nobody else is waiting and there is an admission left
+    if (!bAdmissionControl || NewPlayer->IsLocalController() || (AdmissionQueue.Num() == 0 && TryTakeAdmission()))
+    {
+        Super::HandleStartingNewPlayer_Implementation(NewPlayer);
+        return;
+    }
+
+    AdmissionQueue.Add(NewPlayer);
+    INC_DWORD_STAT(STAT_QueuedPlayers);
+    SendQueuePositions(AdmissionQueue.Num() - 1);
+    UE_LOG(LogMultiplayerSessions, Verbose, TEXT("%s is number %d in the admission queue"), *NewPlayer->GetName(),
+        AdmissionQueue.Num());
+
+    if (!GetWorldTimerManager().IsTimerActive(AdmissionTimerHandle))
+    {
+        GetWorldTimerManager().SetTimer(AdmissionTimerHandle, this, &ThisClass::AdmitQueuedPlayers,
+            1.f / FMath::Max(AdmissionsPerSecond, 0.1f), true);
+    }
+}
+
+void ALobbyGameMode::Logout(AController* Exiting)
+{
+    Super::Logout(Exiting);
+
+    // Gave up while waiting, the players behind move up
+    const int32 QueueIndex = AdmissionQueue.IndexOfByKey(Cast<APlayerController>(Exiting));
+    if (QueueIndex != INDEX_NONE)
+    {
+        AdmissionQueue.RemoveAt(QueueIndex);
+        DEC_DWORD_STAT(STAT_QueuedPlayers);
+        SendQueuePositions(QueueIndex);
+    }
+
+    ALobbyGameState* LobbyGameState = GetGameState<ALobbyGameState>();
+    if (LobbyGameState == nullptr)
+    {
+        return;
+    }
+    // The roster drops the player right away, unlike the PlayerArray which still has it during Logout
+    LobbyGameState->RemovePlayer(Exiting->PlayerState);
+
+    const int32 NumberOfPlayers = LobbyGameState->GetNumRosterPlayers();
+    UE_LOG(LogMultiplayerSessions, Log, TEXT("Players in the lobby: %d"), NumberOfPlayers);
+
+    UpdateMatchStart(NumberOfPlayers);
+}
+
+void ALobbyGameMode::ChangeName(AController* Controller, const FString& NewName, bool bNameChange)
+{
+    Super::ChangeName(Controller, NewName, bNameChange);
+
+    if (ALobbyGameState* LobbyGameState = GetGameState<ALobbyGameState>())
+    {
+        LobbyGameState->SetPlayerName(Controller->PlayerState, NewName);
+    }
+}
+
+APawn* ALobbyGameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+    UClass* PooledPawnClass = GetPooledPawnClass();
+    if (PooledPawnClass == nullptr || GetDefaultPawnClassForController(NewPlayer) != PooledPawnClass)
+    {
+        return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+    }
+
+    while (PooledPawns.Num() > 0)
+    {
+        AMenuSystemCharacter* Pawn = PooledPawns.Pop(EAllowShrinking::No);
+        DEC_DWORD_STAT(STAT_PooledPawns);
+        // Something else may have destroyed it while it was in the pool
+        if (IsValid(Pawn))
+        {
+            Pawn->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+            Pawn->SetPooled(false);
+            ++PawnPoolHits;
+            INC_DWORD_STAT(STAT_PawnPoolHits);
+            return Pawn;
+        }
+    }
+
+    ++PawnPoolMisses;
+    INC_DWORD_STAT(STAT_PawnPoolMisses);
+    return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+}
+
+bool ALobbyGameMode::ReleasePawn(APawn* Pawn)
+{
+    AMenuSystemCharacter* Character = Cast<AMenuSystemCharacter>(Pawn);
+    // Not while leaving for the match, the pawns don't carry over
+    if (Character == nullptr || Character->GetClass() != GetPooledPawnClass() || PooledPawns.Num() >= MaxPooledPawns ||
+        bMatchStarting || GetWorld()->bIsTearingDown)
+    {
+        return false;
+    }
+
+    if (AController* Controller = Character->GetController())
+    {
+        Controller->UnPossess();
+    }
+    Character->SetPooled(true);
+    PooledPawns.Add(Character);
+    INC_DWORD_STAT(STAT_PooledPawns);
+    return true;
+}
+
+void ALobbyGameMode::StartMatchNow()
+{
+    GetWorldTimerManager().ClearTimer(CountdownTimerHandle);
+    StartMatch();
+}
+
+void ALobbyGameMode::HostDedicatedSession()
+{
+    UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem =
+        GetGameInstance() ? GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+    if (MultiplayerSessionsSubsystem == nullptr)
+    {
+        return;
+    }
+    // The session is kept when the players come back to the lobby after a match
+    if (MultiplayerSessionsSubsystem->GetNumPublicConnections() > 0 ||
+        MultiplayerSessionsSubsystem->IsOperationInFlight(ESessionOperation::Create))
+    {
+        return;
+    }
+
+    MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionComplete.AddUniqueDynamic(
+        this, &ThisClass::OnDedicatedSessionCreated);
+    MultiplayerSessionsSubsystem->CreateSession(
+        DedicatedNumPublicConnections, DedicatedMatchType, GetWorld()->GetOutermost()->GetName());
+}
+
+void ALobbyGameMode::OnDedicatedSessionCreated(bool bWasSuccessful)
+{
+    if (UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem =
+            GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>())
+    {
+        MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionComplete.RemoveDynamic(
+            this, &ThisClass::OnDedicatedSessionCreated);
+    }
+
+    if (bWasSuccessful)
+    {
+        UE_LOG(LogMultiplayerSessions, Log, TEXT("Hosting a %s session for %d players"), *DedicatedMatchType,
+            DedicatedNumPublicConnections);
+    }
+    else
+    {
+        UE_LOG(LogMultiplayerSessions, Error, TEXT("Failed to create the session of the dedicated server"));
+    }
+}
+
+void ALobbyGameMode::UpdateMatchStart(int32 NumberOfPlayers)
+{
+    if (!bAutoStartMatch || bMatchStarting)
     {
-        const int32 NumberOfPlayers = GameState.Get()->PlayerArray.Num();
-        if (GEngine)
-            GEngine->AddOnScreenDebugMessage(
-                1, 600.f, FColor::Yellow, FString::Printf(TEXT("Players in game: %d"), NumberOfPlayers));
+        return;
+    }
 
-        if (const APlayerState* PlayerState = NewPlayer->GetPlayerState<APlayerState>())
+    // Not enough players anymore, wait for more
+    if (NumberOfPlayers < MinPlayersToStart)
+    {
+        if (GetWorldTimerManager().IsTimerActive(CountdownTimerHandle))
         {
-            const FString PlayerName = PlayerState->GetPlayerName();
+            GetWorldTimerManager().ClearTimer(CountdownTimerHandle);
             if (GEngine)
-                GEngine->AddOnScreenDebugMessage(-1, 60.f, FColor::Yellow, TEXT("Player name: " + PlayerName));
+                GEngine->AddOnScreenDebugMessage(2, 5.f, FColor::Yellow, TEXT("Waiting for more players"));
         }
+        return;
+    }
+
+    // Nobody else can join, no need to wait for the rest of the countdown
+    const UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem =
+        GetGameInstance() ? GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+    const int32 NumPublicConnections =
+        MultiplayerSessionsSubsystem ? MultiplayerSessionsSubsystem->GetNumPublicConnections() : 0;
+    if (StartCountdown <= 0.f || (bStartWhenFull && NumPublicConnections > 0 && NumberOfPlayers >= NumPublicConnections))
+    {
+        StartMatchNow();
+        return;
+    }
+
+    if (!GetWorldTimerManager().IsTimerActive(CountdownTimerHandle))
+    {
+        CountdownSecondsLeft = FMath::CeilToInt(StartCountdown);
+        GetWorldTimerManager().SetTimer(CountdownTimerHandle, this, &ThisClass::TickCountdown, 1.f, true, 0.f);
     }
 }
 
-void ALobbyGameMode::Logout(AController* Exiting)
+void ALobbyGameMode::TickCountdown()
 {
-    Super::Logout(Exiting);
+    if (CountdownSecondsLeft <= 0)
+    {
+        GetWorldTimerManager().ClearTimer(CountdownTimerHandle);
+        StartMatch();
+        return;
+    }
+    if (GEngine)
+        GEngine->AddOnScreenDebugMessage(
+            2, 1.5f, FColor::Green, FString::Printf(TEXT("Match starting in %d"), CountdownSecondsLeft));
+    --CountdownSecondsLeft;
+}
+
+void ALobbyGameMode::StartMatch()
+{
+    if (bMatchStarting)
+    {
+        return;
+    }
+    bMatchStarting = true;
+
+    // Mark the session as in progress before leaving the lobby, the match travel goes on once the backend answered
+    UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem =
+        GetGameInstance() ? GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+    if (MultiplayerSessionsSubsystem == nullptr)
+    {
+        TravelToMatch();
+        return;
+    }
+    MultiplayerSessionsSubsystem->MultiplayerOnStartSessionComplete.AddUniqueDynamic(this, &ThisClass::OnStartSession);
+    MultiplayerSessionsSubsystem->StartSession();
+}
+
+void ALobbyGameMode::OnStartSession(bool bWasSuccessful)
+{
+    UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>();
+    if (MultiplayerSessionsSubsystem)
+    {
+        MultiplayerSessionsSubsystem->MultiplayerOnStartSessionComplete.RemoveDynamic(this, &ThisClass::OnStartSession);
+    }
+
+    // The match is played either way, the session only stops being advertised as joinable when it started
+    if (!bWasSuccessful)
+    {
+        UE_LOG(LogMultiplayerSessions, Warning, TEXT("Failed to start the session, travelling to the match anyway"));
+    }
+    TravelToMatch();
+}
 
-    if (const APlayerState* PlayerState = Exiting->GetPlayerState<APlayerState>())
+void ALobbyGameMode::PrewarmPawnPool()
+{
+    UClass* PooledPawnClass = GetPooledPawnClass();
+    if (PooledPawnClass == nullptr)
+    {
+        return;
+    }
+
+    // Out of the way of the player starts, they are hidden and don't collide anyway
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    SpawnParameters.ObjectFlags |= RF_Transient;
+    const int32 NumToSpawn = FMath::Min(PawnPoolPrewarmPerFrame, FMath::Min(PawnPoolPrewarm, MaxPooledPawns) - PooledPawns.Num());
+    for (int32 Index = 0; Index < NumToSpawn; ++Index)
+    {
+        AMenuSystemCharacter* Pawn = GetWorld()->SpawnActor<AMenuSystemCharacter>(
+            PooledPawnClass, FTransform(FVector(0.f, 0.f, -1000.f)), SpawnParameters);
+        if (Pawn == nullptr)
+        {
+            return;
+        }
+        Pawn->SetPooled(true);
+        PooledPawns.Add(Pawn);
+        INC_DWORD_STAT(STAT_PooledPawns);
+    }
+
+    if (PooledPawns.Num() < FMath::Min(PawnPoolPrewarm, MaxPooledPawns))
+    {
+        GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::PrewarmPawnPool);
+    }
+}
+
+bool ALobbyGameMode::TryTakeAdmission()
+{
+    // Real time, a hitch of the host must not let a whole queue in at once
+    const double Now = GetWorld()->GetRealTimeSeconds();
+    AdmissionTokens = FMath::Min<double>(AdmissionBurst, AdmissionTokens + (Now - AdmissionRefillTime) * AdmissionsPerSecond);
+    AdmissionRefillTime = Now;
+    if (AdmissionTokens < 1.0)
+    {
+        return false;
+    }
+    AdmissionTokens -= 1.0;
+    return true;
+}
+
+void ALobbyGameMode::AdmitQueuedPlayers()
+{
+    int32 NumAdmitted = 0;
+    while (AdmissionQueue.Num() > 0 && TryTakeAdmission())
+    {
+        APlayerController* Player = AdmissionQueue[0];
+        AdmissionQueue.RemoveAt(0);
+        DEC_DWORD_STAT(STAT_QueuedPlayers);
+        // Destroyed without going through Logout
+        if (!IsValid(Player))
+        {
+            continue;
+        }
+
+        if (ALobbyPlayerController* LobbyPlayerController = Cast<ALobbyPlayerController>(Player))
+        {
+            LobbyPlayerController->ClientSetAdmissionQueuePosition(0);
+        }
+        Super::HandleStartingNewPlayer_Implementation(Player);
+        ++NumAdmitted;
+    }
+
+    if (NumAdmitted > 0)
+    {
+        SendQueuePositions(0);
+    }
+    if (AdmissionQueue.Num() == 0)
+    {
+        GetWorldTimerManager().ClearTimer(AdmissionTimerHandle);
+    }
+}
+
+void ALobbyGameMode::SendQueuePositions(int32 FirstIndex)
+{
+    for (int32 Index = FirstIndex; Index < AdmissionQueue.Num(); ++Index)
+    {
+        if (ALobbyPlayerController* LobbyPlayerController = Cast<ALobbyPlayerController>(AdmissionQueue[Index]))
+        {
+            LobbyPlayerController->ClientSetAdmissionQueuePosition(Index + 1);
+        }
+    }
+}
+
+UClass* ALobbyGameMode::GetPooledPawnClass() const
+{
+    // Only the characters know how to sit in the pool
+    if (!bPoolPawns || DefaultPawnClass == nullptr || !DefaultPawnClass->IsChildOf<AMenuSystemCharacter>())
+    {
+        return nullptr;
+    }
+    return DefaultPawnClass;
+}
+
+void ALobbyGameMode::TravelToMatch()
+{
+    if (UWorld* World = GetWorld())
     {
-        const int32 NumberOfPlayers = GameState.Get()->PlayerArray.Num();
-        if (GEngine)
-            GEngine->AddOnScreenDebugMessage(1, 600.f, FColor::Yellow,
-                FString::Printf(TEXT("Players in game: %d"), NumberOfPlayers - 1));    // TODO temporary hack
+        // bUseSeamlessTravel makes this a seamless travel, the clients follow without reconnecting
+        World->ServerTravel(FString::Printf(TEXT("%s?listen"), *MatchMapPath));
     }
 }
@@ -7,15 +7,152 @@
 
 #include "LobbyGameMode.generated.h"
 
+class AMenuSystemCharacter;
+
 /**
- *
+ * Game mode of the lobby. The players in it are listed in the replicated roster of the ALobbyGameState.
+ * Once enough players are in, it counts down, starts the session and takes everyone to the match with a seamless
+ * travel: the connections and the PlayerStates carry over, so the clients don't reconnect and reload.
+ * The pawns of the players who leave are kept in a pool and handed to the next players who join, instead of destroying
+ * and spawning a character with its mesh, camera and animation every time someone drops in or out.
+ * When many players join at once, their pawns are spawned a few per second and the others wait in an admission queue,
+ * told where they stand in it, so the host doesn't spawn and replicate everyone in the same frames. Players who would
+ * not fit in the session are refused in PreLogin, before anything is spawned for them.
+ * The settings are read from the Game config.
  */
-UCLASS()
+UCLASS(Config = Game)
 class MENUSYSTEM_API ALobbyGameMode : public AGameModeBase
 {
     GENERATED_BODY()
 
 public:
+    ALobbyGameMode();
+
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId,
+        FString& ErrorMessage) override;
     virtual void PostLogin(APlayerController* NewPlayer) override;
+    virtual void HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer) override;
     virtual void Logout(AController* Exiting) override;
+    virtual void ChangeName(AController* Controller, const FString& NewName, bool bNameChange) override;
+    virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+    /** Starts the match now, without waiting for more players or for the countdown. */
+    UFUNCTION(BlueprintCallable, Category = "Lobby")
+    void StartMatchNow();
+
+    /**
+     * Takes the pawn of a leaving player into the pool. The pawn is unpossessed first.
+     * @return false if the pool doesn't want it, e.g. it is full, the caller destroys it then
+     */
+    bool ReleasePawn(APawn* Pawn);
+
+    /** Pawns handed out from the pool and pawns spawned because it was empty, since the lobby opened */
+    int32 GetPawnPoolHits() const { return PawnPoolHits; }
+    int32 GetPawnPoolMisses() const { return PawnPoolMisses; }
+
+    /** Players logged in whose pawn isn't spawned yet, waiting for their turn */
+    int32 GetNumQueuedPlayers() const { return AdmissionQueue.Num(); }
+
+protected:
+    /** Whether the lobby starts the match on its own. When not, StartMatchNow has to be called */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby")
+    bool bAutoStartMatch = true;
+
+    /** Number of players, the host included, that starts the countdown */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby")
+    int32 MinPlayersToStart{2};
+
+    /** Seconds between reaching MinPlayersToStart and travelling to the match, 0 travels right away */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby")
+    float StartCountdown{10.f};
+
+    /** Skip the rest of the countdown once every public connection of the session is taken */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby")
+    bool bStartWhenFull = true;
+
+    /** The map the match is played in */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby")
+    FString MatchMapPath{TEXT("/Game/Maps/MainGameMap")};
+
+    /** Whether the pawns of the players who leave are kept for the next players instead of being destroyed */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Pawn Pool")
+    bool bPoolPawns = true;
+
+    /** Pawns spawned into the pool when the lobby opens, a few per frame */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Pawn Pool")
+    int32 PawnPoolPrewarm{16};
+
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Pawn Pool")
+    int32 PawnPoolPrewarmPerFrame{2};
+
+    /** Most pawns kept in the pool, the pawns of the players who leave beyond that are destroyed */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Pawn Pool")
+    int32 MaxPooledPawns{32};
+
+    /** Whether the players who join at the same time are spawned a few per second instead of all at once */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Admission")
+    bool bAdmissionControl = true;
+
+    /** Players whose pawn is spawned per second once the burst is used up */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Admission", meta = (ClampMin = "0.1"))
+    float AdmissionsPerSecond{4.f};
+
+    /** Players spawned right away after a quiet moment, before the others have to wait */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Admission", meta = (ClampMin = "1"))
+    int32 AdmissionBurst{2};
+
+    /** Most players waiting in the queue, the players joining beyond that are refused until it shrinks. 0 is no limit */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Admission")
+    int32 MaxQueuedPlayers{32};
+
+    /** Match type of the session a dedicated server hosts when it opens the lobby */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Dedicated Server")
+    FString DedicatedMatchType{TEXT("FreeForAll")};
+
+    /** Number of players the session of a dedicated server takes. There is no host, every connection is a player */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby|Dedicated Server")
+    int32 DedicatedNumPublicConnections{100};
+
+private:
+    /** On a dedicated server, creates the session the players find and join, there is no menu to do it. */
+    void HostDedicatedSession();
+    UFUNCTION()
+    void OnDedicatedSessionCreated(bool bWasSuccessful);
+    /** Starts, skips or cancels the countdown after a player came or left. */
+    void UpdateMatchStart(int32 NumberOfPlayers);
+    void TickCountdown();
+    void StartMatch();
+    UFUNCTION()
+    void OnStartSession(bool bWasSuccessful);
+    void TravelToMatch();
+    /** Spawns PawnPoolPrewarmPerFrame pawns into the pool, and again next frame until it holds PawnPoolPrewarm. */
+    void PrewarmPawnPool();
+    /** The class of the pooled pawns, null when the default pawn can't be pooled. */
+    UClass* GetPooledPawnClass() const;
+    /** Takes one admission out of the token bucket, refilled at AdmissionsPerSecond up to AdmissionBurst. */
+    bool TryTakeAdmission();
+    /** Spawns the players at the front of the queue for which there are admissions. */
+    void AdmitQueuedPlayers();
+    /** Tells the queued players, from the index on, where they are in the queue. */
+    void SendQueuePositions(int32 FirstIndex);
+
+    FTimerHandle CountdownTimerHandle;
+    // Whole seconds left on the countdown, shown to the players
+    int32 CountdownSecondsLeft{0};
+    bool bMatchStarting = false;
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<AMenuSystemCharacter>> PooledPawns;
+    int32 PawnPoolHits{0};
+    int32 PawnPoolMisses{0};
+
+    // Logged in players waiting for their pawn, the oldest first
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<APlayerController>> AdmissionQueue;
+    FTimerHandle AdmissionTimerHandle;
+    double AdmissionTokens{0.0};
+    // Real time of the last refill of the tokens
+    double AdmissionRefillTime{0.0};
 };
@@ -0,0 +1,161 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "LobbyGameState.h"
+
+#include "GameFramework/PlayerState.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+void FLobbyRosterEntry::PreReplicatedRemove(const FLobbyRoster& InArraySerializer)
+{
+    if (InArraySerializer.Owner)
+    {
+        InArraySerializer.Owner->NotifyRosterChanged();
+    }
+}
+
+void FLobbyRosterEntry::PostReplicatedAdd(const FLobbyRoster& InArraySerializer)
+{
+    if (InArraySerializer.Owner)
+    {
+        InArraySerializer.Owner->NotifyRosterChanged();
+    }
+}
+
+void FLobbyRosterEntry::PostReplicatedChange(const FLobbyRoster& InArraySerializer)
+{
+    if (InArraySerializer.Owner)
+    {
+        InArraySerializer.Owner->NotifyRosterChanged();
+    }
+}
+
+ALobbyGameState::ALobbyGameState()
+{
+    Roster.Owner = this;
+}
+
+void ALobbyGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    // Push based: the roster is only compared when MarkEntryDirty marked it, instead of every time the game state
+    // is considered for replication
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(ALobbyGameState, Roster, Params);
+}
+
+void ALobbyGameState::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (HasAuthority() && PingUpdateInterval > 0.f)
+    {
+        GetWorldTimerManager().SetTimer(
+            PingUpdateTimerHandle, this, &ThisClass::UpdatePings, PingUpdateInterval, true);
+    }
+}
+
+void ALobbyGameState::AddPlayer(APlayerState* PlayerState)
+{
+    if (PlayerState == nullptr || FindEntry(PlayerState))
+    {
+        return;
+    }
+
+    FLobbyRosterEntry& Entry = Roster.Entries.AddDefaulted_GetRef();
+    Entry.PlayerState = PlayerState;
+    Entry.PlayerName = PlayerState->GetPlayerName();
+    Entry.JoinTime = GetServerWorldTimeSeconds();
+    Entry.PingMs = FMath::RoundToInt(PlayerState->GetPingInMilliseconds());
+    MarkEntryDirty(Entry);
+}
+
+void ALobbyGameState::RemovePlayer(APlayerState* PlayerState)
+{
+    const int32 Index = Roster.Entries.IndexOfByPredicate(
+        [PlayerState](const FLobbyRosterEntry& Entry) { return Entry.PlayerState == PlayerState; });
+    if (Index == INDEX_NONE)
+    {
+        return;
+    }
+
+    // The order of the entries doesn't matter, the fast array identifies them by their replication id
+    Roster.Entries.RemoveAtSwap(Index);
+    Roster.MarkArrayDirty();
+    MARK_PROPERTY_DIRTY_FROM_NAME(ALobbyGameState, Roster, this);
+    NotifyRosterChanged();
+}
+
+void ALobbyGameState::SetPlayerReady(APlayerState* PlayerState, bool bReady)
+{
+    FLobbyRosterEntry* Entry = FindEntry(PlayerState);
+    if (Entry && Entry->bReady != bReady)
+    {
+        Entry->bReady = bReady;
+        MarkEntryDirty(*Entry);
+    }
+}
+
+void ALobbyGameState::SetPlayerName(APlayerState* PlayerState, const FString& PlayerName)
+{
+    FLobbyRosterEntry* Entry = FindEntry(PlayerState);
+    if (Entry && Entry->PlayerName != PlayerName)
+    {
+        Entry->PlayerName = PlayerName;
+        MarkEntryDirty(*Entry);
+    }
+}
+
+bool ALobbyGameState::AreAllPlayersReady() const
+{
+    return Roster.Entries.Num() > 0 &&
+           !Roster.Entries.ContainsByPredicate([](const FLobbyRosterEntry& Entry) { return !Entry.bReady; });
+}
+
+void ALobbyGameState::NotifyRosterChanged()
+{
+    OnRosterChanged.Broadcast();
+}
+
+FLobbyRosterEntry* ALobbyGameState::FindEntry(const APlayerState* PlayerState)
+{
+    return Roster.Entries.FindByPredicate(
+        [PlayerState](const FLobbyRosterEntry& Entry) { return Entry.PlayerState == PlayerState; });
+}
+
+void ALobbyGameState::MarkEntryDirty(FLobbyRosterEntry& Entry)
+{
+    Roster.MarkItemDirty(Entry);
+    MARK_PROPERTY_DIRTY_FROM_NAME(ALobbyGameState, Roster, this);
+    // The server doesn't get the replication callbacks
+    NotifyRosterChanged();
+}
+
+void ALobbyGameState::UpdatePings()
+{
+    bool bAnyChanged = false;
+    for (FLobbyRosterEntry& Entry : Roster.Entries)
+    {
+        if (Entry.PlayerState == nullptr)
+        {
+            continue;
+        }
+        const int32 PingMs = FMath::RoundToInt(Entry.PlayerState->GetPingInMilliseconds());
+        if (FMath::Abs(PingMs - Entry.PingMs) >= PingChangeThresholdMs)
+        {
+            Entry.PingMs = PingMs;
+            Roster.MarkItemDirty(Entry);
+            bAnyChanged = true;
+        }
+    }
+
+    // One dirty mark and one notification for all the pings that changed
+    if (bAnyChanged)
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(ALobbyGameState, Roster, this);
+        NotifyRosterChanged();
+    }
+}
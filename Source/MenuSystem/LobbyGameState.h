@@ -0,0 +1,139 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/Serialization/FastArraySerializer.h"
+
+#include "LobbyGameState.generated.h"
+
+class ALobbyGameState;
+class APlayerState;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnLobbyRosterChanged);
+
+/** A player in the lobby roster */
+USTRUCT(BlueprintType)
+struct FLobbyRosterEntry : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Lobby")
+    TObjectPtr<APlayerState> PlayerState;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Lobby")
+    FString PlayerName;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Lobby")
+    bool bReady = false;
+
+    /** Server world time at which the player joined the lobby, in seconds */
+    UPROPERTY(BlueprintReadOnly, Category = "Lobby")
+    float JoinTime{0.f};
+
+    UPROPERTY(BlueprintReadOnly, Category = "Lobby")
+    int32 PingMs{0};
+
+    // Called on the clients when the entry replicates, see FFastArraySerializer
+    void PreReplicatedRemove(const struct FLobbyRoster& InArraySerializer);
+    void PostReplicatedAdd(const struct FLobbyRoster& InArraySerializer);
+    void PostReplicatedChange(const struct FLobbyRoster& InArraySerializer);
+};
+
+/**
+ * The players in the lobby. It is a fast array, so a change only sends the entries that changed instead of the whole
+ * roster, which matters with a hundred players joining and leaving.
+ */
+USTRUCT()
+struct FLobbyRoster : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FLobbyRosterEntry> Entries;
+
+    // Set by the game state, the entries tell it about the replicated changes
+    UPROPERTY(NotReplicated)
+    TObjectPtr<ALobbyGameState> Owner;
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FLobbyRosterEntry, FLobbyRoster>(Entries, DeltaParms, *this);
+    }
+};
+
+template <>
+struct TStructOpsTypeTraits<FLobbyRoster> : public TStructOpsTypeTraitsBase2<FLobbyRoster>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
+
+/**
+ * Game state of the lobby, it replicates the roster of the players in it.
+ * The roster is push-model replicated: it is only compared for changes after the server marked it dirty, so an idle
+ * roster costs nothing. The server changes it through the functions below, which mark the changed entries dirty.
+ */
+UCLASS(Config = Game)
+class MENUSYSTEM_API ALobbyGameState : public AGameStateBase
+{
+    GENERATED_BODY()
+
+public:
+    ALobbyGameState();
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+    virtual void BeginPlay() override;
+
+    //
+    // Server only, the changes replicate to the clients
+    //
+
+    void AddPlayer(APlayerState* PlayerState);
+    void RemovePlayer(APlayerState* PlayerState);
+    void SetPlayerReady(APlayerState* PlayerState, bool bReady);
+    void SetPlayerName(APlayerState* PlayerState, const FString& PlayerName);
+
+    //
+    // Server and clients
+    //
+
+    UFUNCTION(BlueprintPure, Category = "Lobby")
+    const TArray<FLobbyRosterEntry>& GetRosterEntries() const { return Roster.Entries; }
+
+    UFUNCTION(BlueprintPure, Category = "Lobby")
+    int32 GetNumRosterPlayers() const { return Roster.Entries.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Lobby")
+    bool AreAllPlayersReady() const;
+
+    /** Broadcast when the roster changed, on the server and on the clients */
+    UPROPERTY(BlueprintAssignable, Category = "Lobby")
+    FOnLobbyRosterChanged OnRosterChanged;
+
+    /** Called by the roster when entries replicated. */
+    void NotifyRosterChanged();
+
+protected:
+    /** Seconds between two updates of the pings in the roster */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby")
+    float PingUpdateInterval{2.f};
+
+    /** A ping is only sent again when it changed by at least this much, pings jitter all the time */
+    UPROPERTY(Config, EditAnywhere, Category = "Lobby")
+    int32 PingChangeThresholdMs{10};
+
+private:
+    FLobbyRosterEntry* FindEntry(const APlayerState* PlayerState);
+    /** Marks an entry and the roster dirty, so only that entry is sent */
+    void MarkEntryDirty(FLobbyRosterEntry& Entry);
+    void UpdatePings();
+
+    UPROPERTY(Replicated)
+    FLobbyRoster Roster;
+
+    FTimerHandle PingUpdateTimerHandle;
+};
@@ -0,0 +1,61 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "LobbyPlayerController.h"
+
+#include "LobbyGameMode.h"
+#include "LobbyGameState.h"
+#include "MenuSystemCharacter.h"
+
+void ALobbyPlayerController::SetReady(bool bReady)
+{
+    // On a listen server the host's controller is already on the server
+    ServerSetReady(bReady);
+}
+
+void ALobbyPlayerController::ServerSetReady_Implementation(bool bReady)
+{
+    if (ALobbyGameState* LobbyGameState = GetWorld()->GetGameState<ALobbyGameState>())
+    {
+        LobbyGameState->SetPlayerReady(PlayerState, bReady);
+    }
+}
+
+void ALobbyPlayerController::ServerWakePawn_Implementation()
+{
+    if (AMenuSystemCharacter* Character = GetPawn<AMenuSystemCharacter>())
+    {
+        Character->WakeFromIdle();
+    }
+}
+
+void ALobbyPlayerController::ClientPawnMadeDormant_Implementation()
+{
+    if (AMenuSystemCharacter* Character = GetPawn<AMenuSystemCharacter>())
+    {
+        Character->OnMadeDormant();
+    }
+}
+
+void ALobbyPlayerController::PawnLeavingGame()
+{
+    ALobbyGameMode* LobbyGameMode = GetWorld()->GetAuthGameMode<ALobbyGameMode>();
+    if (GetPawn() && LobbyGameMode && LobbyGameMode->ReleasePawn(GetPawn()))
+    {
+        return;
+    }
+    Super::PawnLeavingGame();
+}
+
+void ALobbyPlayerController::ClientSetAdmissionQueuePosition_Implementation(int32 Position)
+{
+    AdmissionQueuePosition = Position;
+    if (GEngine)
+    {
+        if (Position > 0)
+            GEngine->AddOnScreenDebugMessage(
+                3, 600.f, FColor::Yellow, FString::Printf(TEXT("Joining the lobby, %d ahead of you"), Position - 1));
+        else
+            GEngine->RemoveOnScreenDebugMessage(3);
+    }
+    OnAdmissionQueuePositionChanged.Broadcast(Position);
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+
+#include "LobbyPlayerController.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAdmissionQueuePositionChanged, int32, Position);
+
+/**
+ * Player controller of the lobby, it sends the player's requests to the lobby roster on the server.
+ */
+UCLASS()
+class MENUSYSTEM_API ALobbyPlayerController : public APlayerController
+{
+    GENERATED_BODY()
+
+public:
+    /** Marks the player as ready or not in the lobby roster. */
+    UFUNCTION(BlueprintCallable, Category = "Lobby")
+    void SetReady(bool bReady);
+
+    /** Wakes the pawn up from its idle state on the server. Its own moves don't reach the server while it is dormant */
+    UFUNCTION(Server, Reliable)
+    void ServerWakePawn();
+
+    /** The server made the pawn dormant, the next input of the player calls ServerWakePawn. */
+    UFUNCTION(Client, Reliable)
+    void ClientPawnMadeDormant();
+
+    /** The lobby keeps the pawn of a leaving player for the next player who joins, instead of destroying it. */
+    virtual void PawnLeavingGame() override;
+
+    /** Where the player is in the admission queue of the lobby, 1 is next. 0 once their pawn is spawned. */
+    UFUNCTION(Client, Reliable)
+    void ClientSetAdmissionQueuePosition(int32 Position);
+
+    UFUNCTION(BlueprintPure, Category = "Lobby")
+    int32 GetAdmissionQueuePosition() const { return AdmissionQueuePosition; }
+
+    /** Broadcast on the owning client when the player moved in the admission queue or got out of it */
+    UPROPERTY(BlueprintAssignable, Category = "Lobby")
+    FOnAdmissionQueuePositionChanged OnAdmissionQueuePositionChanged;
+
+protected:
+    UFUNCTION(Server, Reliable)
+    void ServerSetReady(bool bReady);
+
+private:
+    int32 AdmissionQueuePosition{0};
+};
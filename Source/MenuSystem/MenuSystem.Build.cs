@@ -8,6 +8,7 @@ public class MenuSystem : ModuleRules
     {
         PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-        PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "OnlineSubsystem", "OnlineSubsystemSteam"});
+        PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput",
+            "OnlineSubsystem", "OnlineSubsystemSteam", "MultiplayerSessions", "NetCore", "ReplicationGraph"});
     }
 }
@@ -3,3 +3,6 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+// Counters of the game, shown with "stat MenuSystem"
+DECLARE_STATS_GROUP(TEXT("MenuSystem"), STATGROUP_MenuSystem, STATCAT_Advanced);
@@ -4,28 +4,94 @@
 
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Engine/GameInstance.h"
 #include "Engine/LocalPlayer.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "HAL/IConsoleManager.h"
 #include "InputActionValue.h"
-#include "Interfaces/OnlineSessionInterface.h"
-#include "Online/OnlineSessionNames.h"
-#include "OnlineSessionSettings.h"
-#include "OnlineSubsystem.h"
+#include "LobbyPlayerController.h"
+#include "MenuSystem.h"
+#include "MenuSystemReplicationGraph.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "TimerManager.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Idle characters at a low rate"), STAT_LowRateCharacters, STATGROUP_MenuSystem);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant characters"), STAT_DormantCharacters, STATGROUP_MenuSystem);
+
+namespace
+{
+TAutoConsoleVariable<int32> CVarIdleNetMode(TEXT("MenuSystem.IdleNet.Mode"), 2,
+    TEXT("What the server does with the characters of idle players. 0: nothing, 1: replicates them at "
+         "MenuSystem.IdleNet.UpdateFrequency, 2: makes them dormant (in the lobby, a low rate elsewhere)."));
+
+TAutoConsoleVariable<float> CVarIdleNetDelay(TEXT("MenuSystem.IdleNet.Delay"), 10.f,
+    TEXT("Seconds without input or movement after which a character is idle."));
+
+TAutoConsoleVariable<float> CVarIdleNetUpdateFrequency(TEXT("MenuSystem.IdleNet.UpdateFrequency"), 2.f,
+    TEXT("NetUpdateFrequency of the idle characters with MenuSystem.IdleNet.Mode 1."));
+
+// Seconds between two checks of the idle state on the server
+constexpr float IdleCheckInterval = 0.5f;
+
+void BenchmarkCharacterSpawn(const TArray<FString>& Args, UWorld* World)
+{
+    if (World == nullptr)
+    {
+        return;
+    }
+    const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+
+    // The blueprint of the character if the game mode spawns one, it is what a full lobby spawns
+    UClass* CharacterClass = AMenuSystemCharacter::StaticClass();
+    const AGameModeBase* GameMode = World->GetAuthGameMode();
+    if (GameMode && GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(CharacterClass))
+    {
+        CharacterClass = GameMode->DefaultPawnClass;
+    }
+
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    TArray<AActor*> Characters;
+    Characters.Reserve(Count);
+
+    const double StartTime = FPlatformTime::Seconds();
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        // Spread out high above the map, so they don't land on anything while they exist
+        const FVector Location((Index % 10) * 200.f, (Index / 10) * 200.f, 100000.f);
+        Characters.Add(World->SpawnActor<AActor>(CharacterClass, FTransform(Location), SpawnParameters));
+    }
+    const double SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+    for (AActor* Character : Characters)
+    {
+        if (Character)
+        {
+            Character->Destroy();
+        }
+    }
+    UE_LOG(LogTemplateCharacter, Log, TEXT("Spawned %d %s in %.2f ms, %.3f ms each"), Count, *CharacterClass->GetName(), SpawnMs,
+        SpawnMs / Count);
+}
+
+FAutoConsoleCommandWithWorldAndArgs BenchmarkCharacterSpawnCommand(TEXT("MenuSystem.BenchmarkCharacterSpawn"),
+    TEXT("Spawns and destroys Count characters (100 by default) and logs how long the spawns took"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchmarkCharacterSpawn));
+}    // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // AMenuSystemCharacter
 
 AMenuSystemCharacter::AMenuSystemCharacter()
-    :    // These create and set the delegates to call when the session is created and found
-    CreateSessionCompleteDelegate(FOnCreateSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnCreateSessionComplete))
-    , FindSessionsCompleteDelegate(FOnFindSessionsCompleteDelegate::CreateUObject(this, &ThisClass::OnFindSessionsComplete))
-    , JoinSessionCompleteDelegate(FOnJoinSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnJoinSessionComplete))
 {
     // Set size for collision capsule
     GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
@@ -63,104 +129,220 @@ AMenuSystemCharacter::AMenuSystemCharacter()
 
     // Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character)
     // are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
+}
+
+void AMenuSystemCharacter::BeginPlay()
+{
+    // Call the base class
+    Super::BeginPlay();
 
-    IOnlineSubsystem* OnlineSubsystem = IOnlineSubsystem::Get();
-    if (OnlineSubsystem)
+    AwakeNetUpdateFrequency = NetUpdateFrequency;
+    if (HasAuthority())
     {
-        OnlineSessionInterface = OnlineSubsystem->GetSessionInterface();
+        LastActivityTime = GetWorld()->GetTimeSeconds();
+        GetWorldTimerManager().SetTimer(IdleCheckTimerHandle, this, &ThisClass::UpdateIdleState, IdleCheckInterval, true);
+    }
+}
 
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 15.f, FColor::Blue,
-                FString::Printf(TEXT("Found subsystem %s"), *OnlineSubsystem->GetSubsystemName().ToString()));
-        }
+void AMenuSystemCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    GetWorldTimerManager().ClearTimer(IdleCheckTimerHandle);
+    if (IdleNetState == EIdleNetState::LowRate)
+    {
+        DEC_DWORD_STAT(STAT_LowRateCharacters);
+    }
+    else if (IdleNetState == EIdleNetState::Dormant)
+    {
+        DEC_DWORD_STAT(STAT_DormantCharacters);
     }
+    IdleNetState = EIdleNetState::Awake;
+
+    Super::EndPlay(EndPlayReason);
 }
 
-void AMenuSystemCharacter::BeginPlay()
+void AMenuSystemCharacter::WakeFromIdle()
 {
-    // Call the base class
-    Super::BeginPlay();
+    if (HasAuthority())
+    {
+        LastActivityTime = GetWorld()->GetTimeSeconds();
+        SetIdleNetState(EIdleNetState::Awake);
+    }
 }
 
-void AMenuSystemCharacter::CreateGameSession()
+void AMenuSystemCharacter::SetPooled(bool bInPooled)
 {
-    // called when pressed 1 key
-    if (!OnlineSessionInterface.IsValid())
+    if (bPooled == bInPooled || !HasAuthority())
     {
         return;
     }
-    // NAME_GameSession is a predefined name for the session which is accessible globally
-    auto ExistingSession = OnlineSessionInterface->GetNamedSession(NAME_GameSession);
-    // we only want to create a session if one doesn't already exist
-    if (ExistingSession != nullptr)
-    {
-        OnlineSessionInterface->DestroySession(NAME_GameSession);
-    }
-
-    // We need to set the delegate to call when the session is created
-    OnlineSessionInterface->AddOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegate);
-
-    // We create a new session settings object where MakeShareable is a helper function to create a shared pointer
-    TSharedPtr<FOnlineSessionSettings> SessionSettings = MakeShareable(new FOnlineSessionSettings());
-    // We set some session settings
-    SessionSettings->bIsLANMatch = false;            // This is a LAN match
-    SessionSettings->NumPublicConnections = 4;       // This is the maximum number of players that can join the session
-    SessionSettings->bAllowJoinInProgress = true;    // This allows players to join the session even if it has already started
-    SessionSettings->bAllowJoinViaPresence =
-        true;    // This allows players to join the session via presence which is a steam feature to join friends in the same region
-    SessionSettings->bShouldAdvertise =
-        true;    // This allows steam to advertise the session so that other players can see it and join
-    SessionSettings->bUsesPresence = true;             // This allows the session to use presence (steam)
-    SessionSettings->bUseLobbiesIfAvailable = true;    // This allows the session to use lobbies if available, otherwise it crashes
-
-    // We set the match type, so we can search for sessions with the same match type
-    SessionSettings->Set(FName("MatchType"), FString("FreeForAll"), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
-
-    // We need a local player to get a unique net id
-    const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-    // We now create a session with the unique net id, the name NAME_GameSession and the settings we just created
-    OnlineSessionInterface->CreateSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, *SessionSettings);
+    bPooled = bInPooled;
+
+    // Hidden without collision, the default replication doesn't consider it relevant to anyone anymore. The replication
+    // graph doesn't check that, dormancy closes its channels instead
+    SetActorHiddenInGame(bPooled);
+    SetActorEnableCollision(!bPooled);
+    SetActorTickEnabled(!bPooled);
+    GetMesh()->SetComponentTickEnabled(!bPooled);
+    GetCharacterMovement()->StopMovementImmediately();
+    GetCharacterMovement()->SetComponentTickEnabled(!bPooled);
+    StopJumping();
+
+    if (bPooled)
+    {
+        // Nobody controls it, it must not be woken up by the idle checks either
+        GetWorldTimerManager().PauseTimer(IdleCheckTimerHandle);
+        SetIdleNetState(EIdleNetState::Awake);
+        SetNetDormancy(DORM_DormantAll);
+    }
+    else
+    {
+        GetCharacterMovement()->SetDefaultMovementMode();
+        LastActivityTime = GetWorld()->GetTimeSeconds();
+        GetWorldTimerManager().UnPauseTimer(IdleCheckTimerHandle);
+        SetNetDormancy(DORM_Awake);
+        ForceNetUpdate();
+    }
 }
 
-void AMenuSystemCharacter::JoinGameSession()
+void AMenuSystemCharacter::NoteInput()
 {
-    // Find game sessions
-
-    if (!OnlineSessionInterface.IsValid())
+    if (HasAuthority())
     {
-        UE_LOG(LogTemp, Error, TEXT("OnlineSessionInterface is not valid"));
+        // The character of the listen server host
+        WakeFromIdle();
         return;
     }
 
-    // we set the delegate to call when the session search is complete
-    OnlineSessionInterface->AddOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegate);
+    // The moves of a dormant character don't reach the server, the wake up goes through the controller, which is never
+    // dormant. The server tells us when it made the character dormant, even while the player holds an input
+    if (bWakeOnNextInput)
+    {
+        if (ALobbyPlayerController* LobbyPlayerController = GetController<ALobbyPlayerController>())
+        {
+            bWakeOnNextInput = false;
+            LobbyPlayerController->ServerWakePawn();
+        }
+    }
+}
 
-    // We search for sessions with the name NAME_GameSession
-    SessionSearch = MakeShareable(new FOnlineSessionSearch());
+void AMenuSystemCharacter::UpdateIdleState()
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+    const FRotator ControlRotation = GetControlRotation();
+    if (!GetVelocity().IsNearlyZero() || !ControlRotation.Equals(LastControlRotation, 0.1f))
+    {
+        LastActivityTime = Now;
+    }
+    LastControlRotation = ControlRotation;
 
-    // We set some search settings
-    SessionSearch->MaxSearchResults = 10000;    // This is the maximum number of sessions to find
-    SessionSearch->bIsLanQuery = false;         // This is a LAN query
-    SessionSearch->QuerySettings.Set(
-        SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);    // Allows to search for sessions with steam presence
+    EIdleNetState NewState = EIdleNetState::Awake;
+    const int32 Mode = CVarIdleNetMode.GetValueOnGameThread();
+    if (Mode > 0 && Now - LastActivityTime >= CVarIdleNetDelay.GetValueOnGameThread())
+    {
+        // Only the lobby controller can wake a dormant character up on the next input
+        const bool bCanBeDormant = Mode >= 2 && GetController<ALobbyPlayerController>() != nullptr;
+        NewState = bCanBeDormant ? EIdleNetState::Dormant : EIdleNetState::LowRate;
+    }
+    SetIdleNetState(NewState);
+}
+
+void AMenuSystemCharacter::SetIdleNetState(EIdleNetState NewState)
+{
+    if (NewState == IdleNetState)
+    {
+        return;
+    }
+
+    if (IdleNetState == EIdleNetState::LowRate)
+    {
+        DEC_DWORD_STAT(STAT_LowRateCharacters);
+    }
+    else if (IdleNetState == EIdleNetState::Dormant)
+    {
+        DEC_DWORD_STAT(STAT_DormantCharacters);
+    }
 
-    // We need a local player to get a unique net id
-    const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-    // We now search for sessions with the unique net id and the settings we just created
-    OnlineSessionInterface->FindSessions(*LocalPlayer->GetPreferredUniqueNetId(), SessionSearch.ToSharedRef());
+    switch (NewState)
+    {
+        case EIdleNetState::Awake:
+            // Waking up from dormancy sends the current state right away
+            SetNetDormancy(DORM_Awake);
+            SetReplicationFrequency(AwakeNetUpdateFrequency);
+            ForceNetUpdate();
+            break;
+        case EIdleNetState::LowRate:
+            SetNetDormancy(DORM_Awake);
+            SetReplicationFrequency(CVarIdleNetUpdateFrequency.GetValueOnGameThread());
+            INC_DWORD_STAT(STAT_LowRateCharacters);
+            break;
+        case EIdleNetState::Dormant:
+            SetReplicationFrequency(AwakeNetUpdateFrequency);
+            SetNetDormancy(DORM_DormantAll);
+            INC_DWORD_STAT(STAT_DormantCharacters);
+            if (ALobbyPlayerController* LobbyPlayerController = GetController<ALobbyPlayerController>())
+            {
+                LobbyPlayerController->ClientPawnMadeDormant();
+            }
+            break;
+    }
+    IdleNetState = NewState;
 }
 
-// The delegate function to call when the session creation is complete to check that the session was created correctly
-void AMenuSystemCharacter::OnCreateSessionComplete(FName SessionName, bool bWasSuccessful)
+void AMenuSystemCharacter::SetReplicationFrequency(float Frequency)
 {
-    if (bWasSuccessful)
+    NetUpdateFrequency = Frequency;
+
+    // The replication graph reads the frequency of the class when the actor is added, it has to be told about changes
+    if (UNetDriver* NetDriver = GetNetDriver())
     {
-        if (GEngine)
+        if (UMenuSystemReplicationGraph* ReplicationGraph = Cast<UMenuSystemReplicationGraph>(NetDriver->GetReplicationDriver()))
         {
-            GEngine->AddOnScreenDebugMessage(-1, 15.f, FColor::Blue, TEXT("Created session: " + SessionName.ToString()));
+            ReplicationGraph->SetActorNetUpdateFrequency(this, Frequency);
         }
+    }
+}
+
+UMultiplayerSessionsSubsystem* AMenuSystemCharacter::GetMultiplayerSessionsSubsystem() const
+{
+    const UGameInstance* GameInstance = GetGameInstance();
+    return GameInstance ? GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+}
 
+void AMenuSystemCharacter::CreateGameSession()
+{
+    // called when pressed 1 key
+    UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+    if (MultiplayerSessionsSubsystem == nullptr)
+    {
+        return;
+    }
+    // An existing session is replaced, the subsystem destroys or updates it first
+    MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionComplete.AddUniqueDynamic(this, &ThisClass::OnCreateSessionComplete);
+    MultiplayerSessionsSubsystem->CreateSession(4, TEXT("FreeForAll"), TEXT("/Game/Maps/Lobby"));
+}
+
+void AMenuSystemCharacter::JoinGameSession()
+{
+    UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+    if (MultiplayerSessionsSubsystem == nullptr || FindSessionsCompleteHandle.IsValid())
+    {
+        return;
+    }
+    FindSessionsCompleteHandle =
+        MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.AddUObject(this, &ThisClass::OnFindSessionsComplete);
+    MultiplayerSessionsSubsystem->FindSessions(10000, TEXT("FreeForAll"));
+}
+
+// The delegate function to call when the session creation is complete to check that the session was created correctly
+void AMenuSystemCharacter::OnCreateSessionComplete(bool bWasSuccessful)
+{
+    if (UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem())
+    {
+        MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionComplete.RemoveDynamic(this, &ThisClass::OnCreateSessionComplete);
+    }
+
+    if (bWasSuccessful)
+    {
         UWorld* World = GetWorld();
         if (World)
         {
@@ -176,65 +358,45 @@ void AMenuSystemCharacter::OnCreateSessionComplete(FName SessionName, bool bWasS
     }
 }
 
-// The delegate function to call when the session search is complete to check that any sessions were found
-void AMenuSystemCharacter::OnFindSessionsComplete(bool bWasSuccessful)
+// The delegate function to call when the session search is complete, joins the best session found
+void AMenuSystemCharacter::OnFindSessionsComplete(const TArray<FOnlineSessionSearchResult>& SearchResults, bool bWasSuccessful)
 {
-    if (!OnlineSessionInterface.IsValid())
+    UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+    if (MultiplayerSessionsSubsystem == nullptr)
     {
         return;
     }
-    for (const FOnlineSessionSearchResult& SearchResult : SessionSearch->SearchResults)
-    {
-        FString ID = SearchResult.GetSessionIdStr();
-        FString User = SearchResult.Session.OwningUserName;
-        FString MatchType = SearchResult.Session.SessionSettings.Settings.FindRef(FName("MatchType")).Data.ToString();
+    MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.Remove(FindSessionsCompleteHandle);
+    FindSessionsCompleteHandle.Reset();
 
-        FString NumPlayers = FString::FromInt(SearchResult.Session.SessionSettings.NumPublicConnections);
-        FString MaxPlayers = FString::FromInt(SearchResult.Session.SessionSettings.NumPublicConnections);
-        FString Ping = FString::FromInt(SearchResult.PingInMs);
+    JoinSessionCompleteHandle =
+        MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.AddUObject(this, &ThisClass::OnJoinSessionComplete);
+    if (!MultiplayerSessionsSubsystem->JoinBestSession(TEXT("FreeForAll")))
+    {
+        MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.Remove(JoinSessionCompleteHandle);
+        JoinSessionCompleteHandle.Reset();
         if (GEngine)
         {
-            FString Result = FString::Printf(TEXT("ID: %s, User: %s, Match Type: %s, NumPlayers: %s, MaxPlayers: %s, Ping: %s"),
-                *ID, *User, *MatchType, *NumPlayers, *MaxPlayers, *Ping);
-            GEngine->AddOnScreenDebugMessage(-1, 15.f, FColor::Blue, *Result);
-        }
-        // We join the session if it is a FreeForAll match
-        if (MatchType == "FreeForAll")
-        {
-            if (GEngine)
-            {
-                GEngine->AddOnScreenDebugMessage(-1, 15.f, FColor::Blue, TEXT("Joining Match Type: " + MatchType));
-            }
-
-            // We set the delegate to call when the session join is complete
-            OnlineSessionInterface->AddOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegate);
-
-            // We join the session with the unique net id and the session we found
-            const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-            OnlineSessionInterface->JoinSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, SearchResult);
+            GEngine->AddOnScreenDebugMessage(-1, 15.f, FColor::Red, TEXT("No FreeForAll session found"));
         }
     }
 }
 
-void AMenuSystemCharacter::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
+void AMenuSystemCharacter::OnJoinSessionComplete(EOnJoinSessionCompleteResult::Type Result)
 {
-    if (!OnlineSessionInterface.IsValid())
+    UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+    if (MultiplayerSessionsSubsystem == nullptr)
     {
         return;
     }
+    MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.Remove(JoinSessionCompleteHandle);
+    JoinSessionCompleteHandle.Reset();
 
     // We get the connect string to join the session from the session interface. This is an IP address and port
     FString ConnectString;
-    if (OnlineSessionInterface->GetResolvedConnectString(NAME_GameSession, ConnectString))
-    {
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 15.f, FColor::Yellow, TEXT("Connect string: " + ConnectString));
-        }
-    }
-
     APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
-    if (PlayerController)
+    if (Result == EOnJoinSessionCompleteResult::Success && PlayerController &&
+        MultiplayerSessionsSubsystem->GetResolvedConnectString(ConnectString))
     {
         // We travel to the lobby map with the connect string
         PlayerController->ClientTravel(ConnectString, ETravelType::TRAVEL_Absolute);
@@ -269,6 +431,7 @@ void AMenuSystemCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInpu
         // Jumping
         EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &ACharacter::Jump);
         EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
+        EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &AMenuSystemCharacter::NoteInput);
 
         // Moving
         EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AMenuSystemCharacter::Move);
@@ -287,6 +450,8 @@ void AMenuSystemCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInpu
 
 void AMenuSystemCharacter::Move(const FInputActionValue& Value)
 {
+    NoteInput();
+
     // input is a Vector2D
     FVector2D MovementVector = Value.Get<FVector2D>();
 
@@ -310,6 +475,8 @@ void AMenuSystemCharacter::Move(const FInputActionValue& Value)
 
 void AMenuSystemCharacter::Look(const FInputActionValue& Value)
 {
+    NoteInput();
+
     // input is a Vector2D
     FVector2D LookAxisVector = Value.Get<FVector2D>();
 
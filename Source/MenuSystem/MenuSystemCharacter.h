@@ -5,7 +5,6 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Interfaces/OnlineSessionDelegates.h"
-#include "Interfaces/OnlineSessionInterface.h"
 #include "Logging/LogMacros.h"
 
 #include "MenuSystemCharacter.generated.h"
@@ -14,6 +13,8 @@ class USpringArmComponent;
 class UCameraComponent;
 class UInputMappingContext;
 class UInputAction;
+class UMultiplayerSessionsSubsystem;
+class FOnlineSessionSearchResult;
 struct FInputActionValue;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
@@ -64,31 +65,81 @@ protected:
     // To add mapping context
     virtual void BeginPlay();
 
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
     /** Returns CameraBoom subobject **/
     FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
     /** Returns FollowCamera subobject **/
     FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 
-    IOnlineSessionPtr OnlineSessionInterface;
+    /** Server only. Ends the idle state right away, called when the owning player gave input again. */
+    void WakeFromIdle();
+
+    /** Owning client. The server made the character dormant, the next input has to wake it up through the controller. */
+    void OnMadeDormant() { bWakeOnNextInput = true; }
+
+    /**
+     * Server only. Parks the character in the pawn pool of the lobby, or takes it out of it: a pooled character is
+     * hidden, doesn't tick or collide and is dormant until it is handed to the next player.
+     */
+    void SetPooled(bool bInPooled);
+    bool IsPooled() const { return bPooled; }
 
 protected:
+    //
+    // Session shortcuts for testing, the sessions are owned by the UMultiplayerSessionsSubsystem of the game instance.
+    // Nothing online is touched until one of them is called, so spawning a character costs nothing online
+    //
+
+    /** Hosts a FreeForAll session and opens the lobby. */
     UFUNCTION(BlueprintCallable)
     void CreateGameSession();
 
+    /** Joins the best FreeForAll session found and travels to it. */
     UFUNCTION(BlueprintCallable)
     void JoinGameSession();
 
-    // The delegate function to call when the session creation is complete
-    void OnCreateSessionComplete(FName SessionName, bool bWasSuccessful);
-    // The delegate function to call when the session search is complete
-    void OnFindSessionsComplete(bool bWasSuccessful);
-    // The delegate function to call when the session join is complete
-    void OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result);
+    UFUNCTION()
+    void OnCreateSessionComplete(bool bWasSuccessful);
+    void OnFindSessionsComplete(const TArray<FOnlineSessionSearchResult>& SearchResults, bool bWasSuccessful);
+    void OnJoinSessionComplete(EOnJoinSessionCompleteResult::Type Result);
 
 private:
-    FOnCreateSessionCompleteDelegate CreateSessionCompleteDelegate;
-    FOnFindSessionsCompleteDelegate FindSessionsCompleteDelegate;
-    TSharedPtr<FOnlineSessionSearch> SessionSearch;
-    FOnJoinSessionCompleteDelegate JoinSessionCompleteDelegate;
+    /**
+     * How the character replicates while its player is idle, see the MenuSystem.IdleNet CVars.
+     * Most players sit idle in the lobby, their characters don't need to be considered for replication every frame.
+     */
+    enum class EIdleNetState : uint8
+    {
+        Awake,
+        /** Replicated at MenuSystem.IdleNet.UpdateFrequency */
+        LowRate,
+        /** Not replicated at all until woken up */
+        Dormant,
+    };
+
+    /** Called for every input of the local player. */
+    void NoteInput();
+    /** Server only, called on a timer. Puts the character in or out of its idle state. */
+    void UpdateIdleState();
+    void SetIdleNetState(EIdleNetState NewState);
+    void SetReplicationFrequency(float Frequency);
+
+    FTimerHandle IdleCheckTimerHandle;
+    EIdleNetState IdleNetState = EIdleNetState::Awake;
+    // Server, last time the character moved or turned
+    double LastActivityTime{0.0};
+    FRotator LastControlRotation;
+    // Owning client, the character is dormant on the server and our moves don't reach it
+    bool bWakeOnNextInput = false;
+    // The NetUpdateFrequency restored when the character wakes up
+    float AwakeNetUpdateFrequency{0.f};
+    bool bPooled = false;
+
+    UMultiplayerSessionsSubsystem* GetMultiplayerSessionsSubsystem() const;
+
+    // Bound while the search or the join of JoinGameSession runs
+    FDelegateHandle FindSessionsCompleteHandle;
+    FDelegateHandle JoinSessionCompleteHandle;
 };
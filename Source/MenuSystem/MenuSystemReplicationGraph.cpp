@@ -0,0 +1,188 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "MenuSystemReplicationGraph.h"
+
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "ReplicationGraphTypes.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+TAutoConsoleVariable<int32> CVarEnableReplicationGraph(TEXT("MenuSystem.RepGraph.Enable"), 1,
+    TEXT("Whether the game net driver uses the replication graph (1) or the default replication (0). Read when the net "
+         "driver is created, e.g. when the listen server starts."));
+
+UReplicationDriver* CreateReplicationDriver(UNetDriver* ForNetDriver, const FURL& URL, UWorld* World)
+{
+    // Only the game traffic, the beacons and the demo net driver keep the default replication
+    if (CVarEnableReplicationGraph.GetValueOnGameThread() == 0 || ForNetDriver->NetDriverName != NAME_GameNetDriver ||
+        World == nullptr || !World->IsGameWorld())
+    {
+        return nullptr;
+    }
+    return NewObject<UMenuSystemReplicationGraph>(GetTransientPackage());
+}
+
+bool IsSpatialized(EClassRepNodeMapping Mapping)
+{
+    return Mapping >= EClassRepNodeMapping::Spatialize_Static;
+}
+}    // namespace
+
+UMenuSystemReplicationGraph::UMenuSystemReplicationGraph()
+{
+    // Bound once, when the class default object is constructed
+    if (!UReplicationDriver::CreateReplicationDriverDelegate().IsBound())
+    {
+        UReplicationDriver::CreateReplicationDriverDelegate().BindStatic(&CreateReplicationDriver);
+    }
+}
+
+void UMenuSystemReplicationGraph::InitGlobalActorClassSettings()
+{
+    Super::InitGlobalActorClassSettings();
+
+    // Blueprint classes loaded later, like the character blueprint, get the policy and the settings of their native
+    // parent: the class maps look the classes up by their closest known super class
+    for (TObjectIterator<UClass> It; It; ++It)
+    {
+        UClass* Class = *It;
+        const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+        if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated())
+        {
+            continue;
+        }
+        // Skip the blueprint skeleton and reinstancing classes
+        if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+        {
+            continue;
+        }
+
+        EClassRepNodeMapping Mapping = EClassRepNodeMapping::Spatialize_Static;
+        if (ActorCDO->IsA<APlayerState>())
+        {
+            // The player state node finds them itself
+            Mapping = EClassRepNodeMapping::NotRouted;
+        }
+        else if (ActorCDO->bAlwaysRelevant)
+        {
+            Mapping = EClassRepNodeMapping::RelevantAllConnections;
+        }
+        else if (ActorCDO->bOnlyRelevantToOwner)
+        {
+            Mapping = EClassRepNodeMapping::NotRouted;
+        }
+        else if (ActorCDO->IsA<APawn>() || ActorCDO->IsReplicatingMovement() || ActorCDO->bNetUseOwnerRelevancy)
+        {
+            Mapping = EClassRepNodeMapping::Spatialize_Dynamic;
+        }
+        else if (ActorCDO->NetDormancy > DORM_Awake)
+        {
+            Mapping = EClassRepNodeMapping::Spatialize_Dormancy;
+        }
+        ClassRepNodePolicies.Set(Class, Mapping);
+
+        FClassReplicationInfo ClassInfo;
+        ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+        if (IsSpatialized(Mapping))
+        {
+            ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+        }
+        GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+    }
+}
+
+void UMenuSystemReplicationGraph::InitGlobalGraphNodes()
+{
+    GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+    GridNode->CellSize = GridCellSize;
+    GridNode->SpatialBias = FVector2D(GridSpatialBiasX, GridSpatialBiasY);
+    AddGlobalGraphNode(GridNode);
+
+    AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+    AddGlobalGraphNode(AlwaysRelevantNode);
+
+    PlayerStateNode = CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>();
+    PlayerStateNode->TargetActorsPerFrame = PlayerStatesPerFrame;
+    AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UMenuSystemReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+    Super::InitConnectionGraphNodes(RepGraphConnection);
+
+    // The player controller and the view target of the connection, relevant to it wherever they are
+    UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode =
+        CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+    AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+}
+
+void UMenuSystemReplicationGraph::RouteAddNetworkActorToNodes(
+    const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+    switch (GetMappingPolicy(ActorInfo.Class))
+    {
+        case EClassRepNodeMapping::NotRouted:
+            break;
+        case EClassRepNodeMapping::RelevantAllConnections:
+            AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+            break;
+        case EClassRepNodeMapping::Spatialize_Static:
+            GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+            break;
+        case EClassRepNodeMapping::Spatialize_Dynamic:
+            GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+            break;
+        case EClassRepNodeMapping::Spatialize_Dormancy:
+            GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+            break;
+    }
+}
+
+void UMenuSystemReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+    switch (GetMappingPolicy(ActorInfo.Class))
+    {
+        case EClassRepNodeMapping::NotRouted:
+            break;
+        case EClassRepNodeMapping::RelevantAllConnections:
+            AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+            break;
+        case EClassRepNodeMapping::Spatialize_Static:
+            GridNode->RemoveActor_Static(ActorInfo);
+            break;
+        case EClassRepNodeMapping::Spatialize_Dynamic:
+            GridNode->RemoveActor_Dynamic(ActorInfo);
+            break;
+        case EClassRepNodeMapping::Spatialize_Dormancy:
+            GridNode->RemoveActor_Dormancy(ActorInfo);
+            break;
+    }
+}
+
+void UMenuSystemReplicationGraph::SetActorNetUpdateFrequency(AActor* Actor, float NetUpdateFrequency)
+{
+    const uint32 ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(NetUpdateFrequency);
+    if (FGlobalActorReplicationInfo* GlobalInfo = GlobalActorReplicationInfoMap.Find(Actor))
+    {
+        GlobalInfo->Settings.ReplicationPeriodFrame = ReplicationPeriodFrame;
+    }
+    // The connections copied the period when they first considered the actor
+    for (UNetReplicationGraphConnection* Connection : Connections)
+    {
+        if (FConnectionReplicationActorInfo* ConnectionInfo = Connection->ActorInfoMap.Find(Actor))
+        {
+            ConnectionInfo->ReplicationPeriodFrame = ReplicationPeriodFrame;
+        }
+    }
+}
+
+EClassRepNodeMapping UMenuSystemReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+    const EClassRepNodeMapping* Mapping = ClassRepNodePolicies.Get(Class);
+    return Mapping ? *Mapping : EClassRepNodeMapping::NotRouted;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+
+#include "MenuSystemReplicationGraph.generated.h"
+
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_PlayerStateFrequencyLimiter;
+
+/** How the actors of a class are routed to the nodes of the graph */
+enum class EClassRepNodeMapping : uint8
+{
+    /** Not routed to a node, e.g. the player controllers are added by the connection nodes */
+    NotRouted,
+    /** Relevant to every connection, e.g. the game state and its lobby roster */
+    RelevantAllConnections,
+    /** In the grid and never moving */
+    Spatialize_Static,
+    /** In the grid and moving, their cell is updated every frame. The characters */
+    Spatialize_Dynamic,
+    /** In the grid, moving while awake and static while dormant */
+    Spatialize_Dormancy,
+};
+
+/**
+ * Replication graph of the game. With the default replication every actor is checked for relevancy against every
+ * connection, which makes the server CPU grow with the square of the players in a full lobby. Here:
+ *  - the characters are in a 2D grid, a connection only considers the cells around its viewer
+ *  - the game state, and the lobby roster in it, are always relevant and skip the relevancy checks
+ *  - the player states are sent a few per frame instead of all of them every frame
+ *
+ * It replaces the default replication of the game net driver while MenuSystem.RepGraph.Enable is 1, set it to 0 to
+ * compare both, e.g. with the soak test. The grid settings are read from the Engine config.
+ */
+UCLASS(Transient, Config = Engine)
+class MENUSYSTEM_API UMenuSystemReplicationGraph : public UReplicationGraph
+{
+    GENERATED_BODY()
+
+public:
+    UMenuSystemReplicationGraph();
+
+    virtual void InitGlobalActorClassSettings() override;
+    virtual void InitGlobalGraphNodes() override;
+    virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+    virtual void RouteAddNetworkActorToNodes(
+        const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+    virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+    /** Changes how often an actor is considered for replication, the graph only reads NetUpdateFrequency once. */
+    void SetActorNetUpdateFrequency(AActor* Actor, float NetUpdateFrequency);
+
+protected:
+    /** Size of a grid cell, in cm */
+    UPROPERTY(Config)
+    float GridCellSize{10000.f};
+
+    /** Smallest X and Y of the grid. Actors beyond are clamped into the border cells */
+    UPROPERTY(Config)
+    float GridSpatialBiasX{-150000.f};
+
+    UPROPERTY(Config)
+    float GridSpatialBiasY{-150000.f};
+
+    /** Number of player states sent per frame to each connection */
+    UPROPERTY(Config)
+    int32 PlayerStatesPerFrame{4};
+
+private:
+    EClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+    UPROPERTY()
+    TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+    UPROPERTY()
+    TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+    UPROPERTY()
+    TObjectPtr<UReplicationGraphNode_PlayerStateFrequencyLimiter> PlayerStateNode;
+
+    TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
+};
@@ -0,0 +1,330 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#include "SoakTestSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "LobbyGameMode.h"
+#include "Misc/CommandLine.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "OnlineSessionSettings.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSoakTest, Log, All);
+
+bool USoakTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const TCHAR* CommandLine = FCommandLine::Get();
+    return Super::ShouldCreateSubsystem(Outer) &&
+           (FParse::Param(CommandLine, TEXT("SoakHost")) || FParse::Param(CommandLine, TEXT("SoakClient")));
+}
+
+void USoakTestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+    // We bind to the sessions subsystem delegates, make sure it exists first
+    Collection.InitializeDependency<UMultiplayerSessionsSubsystem>();
+
+    const TCHAR* CommandLine = FCommandLine::Get();
+    bIsHost = FParse::Param(CommandLine, TEXT("SoakHost"));
+    FParse::Value(CommandLine, TEXT("SoakMatchType="), MatchType);
+    FParse::Value(CommandLine, TEXT("SoakLobbyPath="), LobbyPath);
+    FParse::Value(CommandLine, TEXT("SoakMaxPlayers="), NumPublicConnections);
+    FParse::Value(CommandLine, TEXT("SoakDuration="), SoakDuration);
+    FParse::Value(CommandLine, TEXT("SoakJoinTimeout="), JoinTimeout);
+
+    if (UMultiplayerSessionsSubsystem* SessionsSubsystem = GetSessionsSubsystem())
+    {
+        if (bIsHost)
+        {
+            SessionsSubsystem->MultiplayerOnCreateSessionComplete.AddDynamic(this, &ThisClass::OnHostCreateSession);
+        }
+        else
+        {
+            SessionsSubsystem->MultiplayerOnFindSessionsComplete.AddUObject(this, &ThisClass::OnClientFindSessions);
+            SessionsSubsystem->MultiplayerOnJoinSessionComplete.AddUObject(this, &ThisClass::OnClientJoinSession);
+        }
+    }
+
+    // The flow starts on the first map and ends on the lobby
+    PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::OnPostLoadMapWithWorld);
+    if (!bIsHost && GEngine)
+    {
+        TravelFailureHandle = GEngine->OnTravelFailure().AddUObject(this, &ThisClass::OnTravelFailure);
+        NetworkFailureHandle = GEngine->OnNetworkFailure().AddUObject(this, &ThisClass::OnNetworkFailure);
+        JoinTimeoutTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &ThisClass::OnJoinTimeout), JoinTimeout);
+    }
+    if (SoakDuration > 0.f)
+    {
+        SoakDurationTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &ThisClass::OnSoakDurationElapsed), SoakDuration);
+    }
+
+    SoakStartTime = FPlatformTime::Seconds();
+    UE_LOG(LogSoakTest, Log, TEXT("Soak %s started, match type %s, lobby %s, duration %.0fs"),
+        bIsHost ? TEXT("host") : TEXT("client"), *MatchType, *LobbyPath, SoakDuration);
+}
+
+void USoakTestSubsystem::Deinitialize()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(HostStatsTickerHandle);
+    FTSTicker::GetCoreTicker().RemoveTicker(FindRetryTickerHandle);
+    FTSTicker::GetCoreTicker().RemoveTicker(JoinTimeoutTickerHandle);
+    FTSTicker::GetCoreTicker().RemoveTicker(SoakDurationTickerHandle);
+    FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+    if (GEngine)
+    {
+        GEngine->OnTravelFailure().Remove(TravelFailureHandle);
+        GEngine->OnNetworkFailure().Remove(NetworkFailureHandle);
+    }
+    if (UMultiplayerSessionsSubsystem* SessionsSubsystem = GetSessionsSubsystem())
+    {
+        SessionsSubsystem->MultiplayerOnCreateSessionComplete.RemoveAll(this);
+        SessionsSubsystem->MultiplayerOnFindSessionsComplete.RemoveAll(this);
+        SessionsSubsystem->MultiplayerOnJoinSessionComplete.RemoveAll(this);
+    }
+
+    Super::Deinitialize();
+}
+
+UMultiplayerSessionsSubsystem* USoakTestSubsystem::GetSessionsSubsystem() const
+{
+    const UGameInstance* GameInstance = GetGameInstance();
+    return GameInstance ? GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+}
+
+void USoakTestSubsystem::OnPostLoadMapWithWorld(UWorld* LoadedWorld)
+{
+    if (LoadedWorld == nullptr || LoadedWorld->GetGameInstance() != GetGameInstance())
+    {
+        return;
+    }
+
+    const FString PackageName = UWorld::RemovePIEPrefix(LoadedWorld->GetOutermost()->GetName());
+    if (PackageName != LobbyPath)
+    {
+        // The first map after startup, kick off the session flow once
+        if (!bSessionRequested)
+        {
+            bSessionRequested = true;
+            if (bIsHost)
+            {
+                HostSession();
+            }
+            else
+            {
+                FindHostSession();
+            }
+        }
+        return;
+    }
+
+    if (bIsHost)
+    {
+        UE_LOG(LogSoakTest, Log, TEXT("SoakHost: Listening Time=%.1f"), FPlatformTime::Seconds() - SoakStartTime);
+        StatsWindowStart = FPlatformTime::Seconds();
+        HostStatsTickerHandle =
+            FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::TickHostStats));
+    }
+    else if (ClientStep == ESoakClientStep::Traveling)
+    {
+        ReportClientResult(TEXT("Joined"));
+    }
+}
+
+bool USoakTestSubsystem::OnSoakDurationElapsed(float DeltaTime)
+{
+    UE_LOG(LogSoakTest, Log, TEXT("Soak duration of %.0fs elapsed, exiting"), SoakDuration);
+    if (!bIsHost)
+    {
+        ReportClientResult(TEXT("Timeout"));
+    }
+    FPlatformMisc::RequestExit(false, TEXT("USoakTestSubsystem"));
+    return false;
+}
+
+// Host
+
+void USoakTestSubsystem::HostSession()
+{
+    if (UMultiplayerSessionsSubsystem* SessionsSubsystem = GetSessionsSubsystem())
+    {
+        SessionsSubsystem->CreateSession(NumPublicConnections, MatchType, LobbyPath);
+    }
+}
+
+void USoakTestSubsystem::OnHostCreateSession(bool bWasSuccessful)
+{
+    if (!bWasSuccessful)
+    {
+        UE_LOG(LogSoakTest, Error, TEXT("SoakHost: Failed to create the session"));
+        FPlatformMisc::RequestExit(false, TEXT("USoakTestSubsystem"));
+        return;
+    }
+
+    // The menu travels to the lobby too when it is on screen, only travel if it did not
+    UWorld* World = GetGameInstance()->GetWorld();
+    if (World && World->NextURL.IsEmpty())
+    {
+        World->ServerTravel(FString::Printf(TEXT("%s?listen"), *LobbyPath));
+    }
+}
+
+bool USoakTestSubsystem::TickHostStats(float DeltaTime)
+{
+    StatsWindowFrameTime += DeltaTime;
+    StatsWindowMaxFrameTime = FMath::Max<double>(StatsWindowMaxFrameTime, DeltaTime);
+    ++StatsWindowFrames;
+
+    const double Now = FPlatformTime::Seconds();
+    if (Now - StatsWindowStart < 1.0)
+    {
+        return true;
+    }
+
+    // The net driver already averages the bandwidth over the last second
+    const UWorld* World = GetGameInstance()->GetWorld();
+    const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+    const ALobbyGameMode* LobbyGameMode = World ? World->GetAuthGameMode<ALobbyGameMode>() : nullptr;
+    UE_LOG(LogSoakTest, Log,
+        TEXT("SoakHost: Time=%.1f Frames=%d AvgFrameMs=%.2f MaxFrameMs=%.2f Clients=%d InBytesPerSec=%u OutBytesPerSec=%u "
+             "PoolHits=%d PoolMisses=%d Queued=%d"),
+        Now - SoakStartTime, StatsWindowFrames, 1000.0 * StatsWindowFrameTime / StatsWindowFrames,
+        1000.0 * StatsWindowMaxFrameTime, NetDriver ? NetDriver->ClientConnections.Num() : 0,
+        NetDriver ? NetDriver->InBytesPerSecond : 0, NetDriver ? NetDriver->OutBytesPerSecond : 0,
+        LobbyGameMode ? LobbyGameMode->GetPawnPoolHits() : 0, LobbyGameMode ? LobbyGameMode->GetPawnPoolMisses() : 0,
+        LobbyGameMode ? LobbyGameMode->GetNumQueuedPlayers() : 0);
+
+    StatsWindowStart = Now;
+    StatsWindowFrameTime = 0.0;
+    StatsWindowMaxFrameTime = 0.0;
+    StatsWindowFrames = 0;
+    return true;
+}
+
+// Client
+
+void USoakTestSubsystem::FindHostSession()
+{
+    UMultiplayerSessionsSubsystem* SessionsSubsystem = GetSessionsSubsystem();
+    if (SessionsSubsystem == nullptr || ClientStep == ESoakClientStep::Done)
+    {
+        return;
+    }
+
+    ClientStep = ESoakClientStep::Finding;
+    ++NumFindAttempts;
+    FindStartTime = FPlatformTime::Seconds();
+    if (FirstFindStartTime == 0.0)
+    {
+        FirstFindStartTime = FindStartTime;
+    }
+
+    // Measure a real search every time, a cached empty result would also hide a host that just came up
+    SessionsSubsystem->InvalidateSessionSearchCache();
+    SessionsSubsystem->FindSessions(10000, MatchType);
+}
+
+bool USoakTestSubsystem::RetryFindHostSession(float DeltaTime)
+{
+    FindHostSession();
+    return false;
+}
+
+void USoakTestSubsystem::OnClientFindSessions(const TArray<FOnlineSessionSearchResult>& SearchResults, bool bWasSuccessful)
+{
+    UMultiplayerSessionsSubsystem* SessionsSubsystem = GetSessionsSubsystem();
+    if (SessionsSubsystem == nullptr || ClientStep != ESoakClientStep::Finding)
+    {
+        return;
+    }
+
+    FindDuration = FPlatformTime::Seconds() - FindStartTime;
+    NumSessionsFound = SearchResults.Num();
+
+    ClientStep = ESoakClientStep::Joining;
+    JoinStartTime = FPlatformTime::Seconds();
+    // Fails over to the next ranked sessions by itself, we only hear back once one joined or all failed
+    if (!SessionsSubsystem->JoinBestSession(MatchType))
+    {
+        // The host may not be advertising yet
+        ClientStep = ESoakClientStep::Finding;
+        UE_LOG(LogSoakTest, Log, TEXT("No session found on attempt %d, searching again in %.0fs"), NumFindAttempts,
+            FindRetryDelay);
+        FindRetryTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &ThisClass::RetryFindHostSession), FindRetryDelay);
+    }
+}
+
+void USoakTestSubsystem::OnClientJoinSession(EOnJoinSessionCompleteResult::Type Result)
+{
+    UMultiplayerSessionsSubsystem* SessionsSubsystem = GetSessionsSubsystem();
+    if (SessionsSubsystem == nullptr || ClientStep != ESoakClientStep::Joining)
+    {
+        return;
+    }
+
+    JoinDuration = FPlatformTime::Seconds() - JoinStartTime;
+
+    FString ConnectString;
+    if (Result != EOnJoinSessionCompleteResult::Success || !SessionsSubsystem->GetResolvedConnectString(ConnectString))
+    {
+        UE_LOG(LogSoakTest, Warning, TEXT("Failed to join the session (%s), searching again in %.0fs"), LexToString(Result),
+            FindRetryDelay);
+        FindRetryTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &ThisClass::RetryFindHostSession), FindRetryDelay);
+        return;
+    }
+
+    ClientStep = ESoakClientStep::Traveling;
+    TravelStartTime = FPlatformTime::Seconds();
+
+    // The menu travels to the session too when it is on screen, only travel if it did not
+    const FWorldContext* WorldContext = GetGameInstance()->GetWorldContext();
+    APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+    if (PlayerController && WorldContext && WorldContext->TravelURL.IsEmpty())
+    {
+        PlayerController->ClientTravel(ConnectString, ETravelType::TRAVEL_Absolute);
+    }
+}
+
+void USoakTestSubsystem::OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString)
+{
+    UE_LOG(LogSoakTest, Warning, TEXT("Travel failure %s: %s"), ETravelFailure::ToString(FailureType), *ErrorString);
+    ReportClientResult(TEXT("TravelFailure"));
+}
+
+void USoakTestSubsystem::OnNetworkFailure(
+    UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+    UE_LOG(LogSoakTest, Warning, TEXT("Network failure %s: %s"), ENetworkFailure::ToString(FailureType), *ErrorString);
+    ReportClientResult(TEXT("NetworkFailure"));
+}
+
+bool USoakTestSubsystem::OnJoinTimeout(float DeltaTime)
+{
+    ReportClientResult(TEXT("Timeout"));
+    return false;
+}
+
+void USoakTestSubsystem::ReportClientResult(const TCHAR* Outcome)
+{
+    // Only the first outcome counts, e.g. the host going away after we joined is not a failure
+    if (ClientStep == ESoakClientStep::Done)
+    {
+        return;
+    }
+    const bool bTraveled = ClientStep == ESoakClientStep::Traveling;
+    ClientStep = ESoakClientStep::Done;
+    FTSTicker::GetCoreTicker().RemoveTicker(FindRetryTickerHandle);
+    FTSTicker::GetCoreTicker().RemoveTicker(JoinTimeoutTickerHandle);
+
+    const double Now = FPlatformTime::Seconds();
+    UE_LOG(LogSoakTest, Log,
+        TEXT("SoakResult: Outcome=%s FindMs=%.1f JoinMs=%.1f TravelMs=%.1f TotalMs=%.1f FindAttempts=%d SessionsFound=%d"),
+        Outcome, 1000.0 * FindDuration, 1000.0 * JoinDuration, bTraveled ? 1000.0 * (Now - TravelStartTime) : 0.0,
+        FirstFindStartTime > 0.0 ? 1000.0 * (Now - FirstFindStartTime) : 0.0, NumFindAttempts, NumSessionsFound);
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2023-2024 Rasna Studios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "SoakTestSubsystem.generated.h"
+
+class UMultiplayerSessionsSubsystem;
+class UNetDriver;
+
+/** Where a soak client is in the find -> join -> travel flow */
+enum class ESoakClientStep : uint8
+{
+    Idle,
+    Finding,
+    Joining,
+    Traveling,
+    Done
+};
+
+/**
+ * Drives a headless soak run of the session flow, launched by Scripts/soak_lobby.py.
+ * It is only created when the game runs with -SoakHost or -SoakClient:
+ *  - the host creates a session, travels to the lobby as a listen server and logs frame time and bandwidth every second
+ *  - a client finds the session, joins it, travels to the lobby and logs how long each step took
+ * The lines the script parses start with "SoakHost:" and "SoakResult:".
+ */
+UCLASS()
+class MENUSYSTEM_API USoakTestSubsystem : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+private:
+    UMultiplayerSessionsSubsystem* GetSessionsSubsystem() const;
+    void OnPostLoadMapWithWorld(UWorld* LoadedWorld);
+    bool OnSoakDurationElapsed(float DeltaTime);
+
+    // Host
+    void HostSession();
+    UFUNCTION()
+    void OnHostCreateSession(bool bWasSuccessful);
+    bool TickHostStats(float DeltaTime);
+
+    // Client
+    void FindHostSession();
+    bool RetryFindHostSession(float DeltaTime);
+    void OnClientFindSessions(const TArray<FOnlineSessionSearchResult>& SearchResults, bool bWasSuccessful);
+    void OnClientJoinSession(EOnJoinSessionCompleteResult::Type Result);
+    void OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString);
+    void OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+    bool OnJoinTimeout(float DeltaTime);
+    void ReportClientResult(const TCHAR* Outcome);
+
+    bool bIsHost = false;
+    FString MatchType{TEXT("FreeForAll")};
+    FString LobbyPath{TEXT("/Game/Maps/Lobby")};
+    int32 NumPublicConnections{100};
+    /** Seconds after which the process exits, 0 keeps it running until it gets killed */
+    float SoakDuration{0.f};
+    /** Seconds a client has to get into the lobby before it reports a timeout */
+    float JoinTimeout{120.f};
+    /** Seconds a client waits before searching again when the host is not advertising yet */
+    float FindRetryDelay{2.f};
+
+    bool bSessionRequested = false;
+    ESoakClientStep ClientStep = ESoakClientStep::Idle;
+    int32 NumFindAttempts = 0;
+    int32 NumSessionsFound = 0;
+
+    // Timestamps in seconds, from FPlatformTime::Seconds()
+    double SoakStartTime = 0.0;
+    double FirstFindStartTime = 0.0;
+    double FindStartTime = 0.0;
+    double FindDuration = 0.0;
+    double JoinStartTime = 0.0;
+    double JoinDuration = 0.0;
+    double TravelStartTime = 0.0;
+
+    // Frame times of the host over the current one second stats window
+    double StatsWindowStart = 0.0;
+    double StatsWindowFrameTime = 0.0;
+    double StatsWindowMaxFrameTime = 0.0;
+    int32 StatsWindowFrames = 0;
+
+    FTSTicker::FDelegateHandle HostStatsTickerHandle;
+    FTSTicker::FDelegateHandle FindRetryTickerHandle;
+    FTSTicker::FDelegateHandle JoinTimeoutTickerHandle;
+    FTSTicker::FDelegateHandle SoakDurationTickerHandle;
+    FDelegateHandle PostLoadMapHandle;
+    FDelegateHandle TravelFailureHandle;
+    FDelegateHandle NetworkFailureHandle;
+};